@@ -18,7 +18,8 @@
 
 evd::Controller::Controller(std::unique_ptr<YAML::Node>&& config, 
                             std::unique_ptr<src::Source>&& source): fWindow(new Window(std::move(config), std::move(source))), 
-                                                                    fState(std::unique_ptr<fsm::State>(new fsm::FirstEvent()))
+                                                                    fState(std::unique_ptr<fsm::State>(new fsm::FirstEvent())),
+                                                                    fTransitioned(true)
 {
 }
 
@@ -33,9 +34,15 @@ evd::Controller::~Controller()
 void evd::Controller::Render(const int width, const int height, const ImGuiIO& ioState)
 {
   auto newState = fState->poll(width, height, ioState, *fWindow);
+  fTransitioned = (newState != nullptr);
   if(newState) fState = std::move(newState); //Implement State transition if requested
 }
 
+bool evd::Controller::NeedsFrame() const
+{
+  return fTransitioned || fWindow->NeedsFrame();
+}
+
 std::unique_ptr<src::Source> evd::Controller::FindSource(const int argc, const char** argv) const
 {
   std::vector<std::string> rootFiles;
@@ -41,9 +41,14 @@ namespace evd
 
       void Render(const int width, const int height, const ImGuiIO& ioState); //Render one frame.
 
+      //Would drawing a frame now change anything without new input?  The application's main loop waits for input 
+      //instead of calling Render() while this is false.
+      bool NeedsFrame() const;
+
     private:
       std::unique_ptr<Window> fWindow; //The window rendering the user's data
       std::unique_ptr<fsm::State> fState; //The current user interaction mode
+      bool fTransitioned; //Did fState change in the last Render()?  A new State always gets at least one frame.
 
       //Helper functions to configure a Controller from the command line
       std::unique_ptr<src::Source> FindSource(const int argc, const char** argv) const;
@@ -0,0 +1,327 @@
+//File: EvdBatch.cpp
+//Brief: Render events to image files without a user.  Uses the same evd::Window, plugins, and event prefetching as
+//       GLFWApp, but draws each event into an offscreen Framebuffer and hands the pixels to an ImageWriter so that
+//       images are compressed and written while the next event renders.  Reports throughput in events/second.
+//
+//       Usage: EvdBatch [config.yaml] file.root... [options]
+//       --events <file>      Only render the (run, event) pairs listed one per line in file.  Otherwise, render every event.
+//       --max <n>            Stop after rendering n events
+//       --output <dir>       Directory for images.  Created if it doesn't exist.
+//       --format <ext>       Image format by file extension: png, jpg, gif, tiff...
+//       --width <pixels>     Width of each image
+//       --height <pixels>    Height of each image
+//       --camera <name>      Name of a Camera from the Camera plugins to draw each event with
+//       --cut <scene>=<cut>  Apply cut to the Scene named scene as if it was typed into the cut bar.  Can be repeated.
+//       --threads <n>        Number of images to compress at the same time
+//
+//       Defaults for all options except --events and --max come from an optional Batch block in the configuration file:
+//       Batch:
+//         Width: 1920
+//         Height: 1080
+//         Format: png
+//         Output: gallery
+//         Camera: "Front"
+//         Threads: 2
+//         Cuts:
+//           TrajPts: "@2 > 10"
+//       Images are named like the Print button names them.  See the Print block in evd::Window.
+//
+//       On a Linux node without a display, EvdBatch asks GLFW for an OSMesa context without a display server.  This
+//       needs GLFW 3.4 or later built with OSMesa support.  Otherwise, run EvdBatch under xvfb-run.  Set
+//       LIBGL_ALWAYS_SOFTWARE=1 to force Mesa's software renderer.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//GLAD include(s)
+#include "glad/include/glad/glad.h"
+
+//glfw include(s)
+#include <GLFW/glfw3.h>
+
+//local includes
+#include "app/Window.h"
+#include "app/ImageWriter.h"
+#include "app/CmdLine.cpp"
+
+//gl includes
+#include "gl/objects/Framebuffer.h"
+#include "gl/objects/PixelBuffer.h"
+
+//ROOT includes
+#include "TSystem.h"
+#include "TROOT.h" //For ROOT::EnableThreadSafety()
+
+//c++ includes
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+
+namespace
+{
+  //Everything EvdBatch can be configured to do
+  struct BatchConfig
+  {
+    BatchConfig(): fWidth(1920), fHeight(1080), fFormat("png"), fOutput("."), fCamera(), fThreads(1),
+                   fMaxEvents(std::numeric_limits<size_t>::max())
+    {
+    }
+
+    int fWidth;
+    int fHeight;
+    std::string fFormat;
+    std::string fOutput;
+    std::string fCamera;
+    size_t fThreads;
+    size_t fMaxEvents;
+    std::map<std::string, std::string> fCuts; //Scene name to cut
+    std::vector<std::pair<int, int>> fEvents; //(run, event) to render.  Render everything if empty.
+  };
+
+  void ReadBatchBlock(const YAML::Node& config, BatchConfig& batch)
+  {
+    if(!config["Batch"]) return;
+    const auto& block = config["Batch"];
+    if(block["Width"]) batch.fWidth = block["Width"].as<int>();
+    if(block["Height"]) batch.fHeight = block["Height"].as<int>();
+    if(block["Format"]) batch.fFormat = block["Format"].as<std::string>();
+    if(block["Output"]) batch.fOutput = block["Output"].as<std::string>();
+    if(block["Camera"]) batch.fCamera = block["Camera"].as<std::string>();
+    if(block["Threads"]) batch.fThreads = block["Threads"].as<size_t>();
+    if(block["Cuts"])
+    {
+      for(const auto& cut: block["Cuts"]) batch.fCuts[cut.first.as<std::string>()] = cut.second.as<std::string>();
+    }
+  }
+
+  //Lines of "run event".  Blank lines and lines starting with # are skipped.
+  std::vector<std::pair<int, int>> ReadEventList(const std::string& fileName)
+  {
+    std::ifstream file(fileName);
+    if(!file) throw util::GenException("Event List") << "Couldn't open a list of events named " << fileName << "\n";
+
+    std::vector<std::pair<int, int>> events;
+    std::string line;
+    while(std::getline(file, line))
+    {
+      if(line.empty() || line[0] == '#') continue;
+      std::stringstream parse(line);
+      int run, event;
+      if(!(parse >> run >> event)) throw util::GenException("Event List") << "Expected \"run event\" in " << fileName << ", but got: " << line << "\n";
+      events.emplace_back(run, event);
+    }
+    return events;
+  }
+
+  //Command line options override the Batch block
+  void ReadOptions(const int argc, const char** argv, BatchConfig& batch)
+  {
+    for(int arg = 1; arg < argc; ++arg)
+    {
+      const std::string option(argv[arg]);
+      if(option.compare(0, 2, "--") != 0) continue; //Input and configuration files are found by cmd::FindSource() and cmd::FindConfig()
+      if(arg + 1 >= argc) throw util::GenException("Command Line") << option << " needs a value.\n";
+      const std::string value(argv[++arg]);
+
+      if(option == "--events") batch.fEvents = ReadEventList(value);
+      else if(option == "--max") batch.fMaxEvents = std::stoul(value);
+      else if(option == "--output") batch.fOutput = value;
+      else if(option == "--format") batch.fFormat = value;
+      else if(option == "--width") batch.fWidth = std::stoi(value);
+      else if(option == "--height") batch.fHeight = std::stoi(value);
+      else if(option == "--camera") batch.fCamera = value;
+      else if(option == "--threads") batch.fThreads = std::stoul(value);
+      else if(option == "--cut")
+      {
+        const auto equals = value.find('=');
+        if(equals == std::string::npos) throw util::GenException("Command Line") << "--cut needs <scene>=<cut>, but got " << value << "\n";
+        batch.fCuts[value.substr(0, equals)] = value.substr(equals+1);
+      }
+      else throw util::GenException("Command Line") << "Unknown option " << option << ".  See the top of EvdBatch.cpp for usage.\n";
+    }
+  }
+
+  //A hidden window is the most portable way to get an OpenGL context from GLFW.  Without a display server, try to get a
+  //context that doesn't need one.
+  GLFWwindow* MakeOffscreenContext()
+  {
+    const bool headless = !std::getenv("DISPLAY") && !std::getenv("WAYLAND_DISPLAY");
+    #ifdef GLFW_PLATFORM_NULL //GLFW 3.4 and later can run without a display server
+    if(headless) glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    #endif
+    if(!glfwInit()) return nullptr;
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    #if __APPLE__
+      glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    #endif
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    #ifdef GLFW_OSMESA_CONTEXT_API
+    if(headless) glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+    #endif
+
+    return glfwCreateWindow(64, 64, "EvdBatch", nullptr, nullptr); //Everything is drawn in a Framebuffer, so size doesn't matter
+  }
+}
+
+int main(const int argc, const char** argv)
+{
+  //evd::Window reads events on other threads, and ImageWriter makes TASImages on other threads.  ROOT has to know 
+  //about this before any of them starts.
+  ROOT::EnableThreadSafety();
+
+  BatchConfig batch;
+  auto config = cmd::FindConfig(argc, argv);
+  auto source = cmd::FindSource(argc, argv);
+  if(!source)
+  {
+    std::cerr << "Usage: EvdBatch [config.yaml] file.root... [options].  See the top of EvdBatch.cpp for options.\n";
+    return 1;
+  }
+
+  try
+  {
+    ReadBatchBlock(*config, batch);
+    ReadOptions(argc, argv, batch);
+  }
+  catch(const std::exception& e)
+  {
+    std::cerr << e.what();
+    return 1;
+  }
+  if(batch.fOutput.empty()) batch.fOutput = ".";
+  gSystem->mkdir(batch.fOutput.c_str(), true);
+
+  auto context = MakeOffscreenContext();
+  if(!context)
+  {
+    std::cerr << "Couldn't create an OpenGL context.  On a node without a display, build GLFW 3.4 or later with OSMesa or "
+              << "run EvdBatch under xvfb-run.\n";
+    glfwTerminate();
+    return 1;
+  }
+  glfwMakeContextCurrent(context);
+  glfwSwapInterval(0); //Nothing is ever shown, so don't wait for the monitor
+  gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+  gladLoadGL();
+
+  const int width = batch.fWidth, height = batch.fHeight;
+  size_t nRendered = 0;
+  try
+  {
+    //evd::Window starts reading the first event in the Source as soon as it is created
+    evd::Window evd(std::move(config), std::move(source));
+    for(const auto& cut: batch.fCuts) evd.SetCut(cut.first, cut.second);
+
+    mygl::Framebuffer target;
+    target.Resize(width, height);
+    evd::ImageWriter writer(batch.fThreads);
+
+    //Pixels are read back while the next event renders.  Each PixelBuffer holds one event.
+    std::array<mygl::PixelBuffer, 2> readback;
+    std::array<std::string, 2> names;
+    const auto flush = [&](const size_t slot)
+                       {
+                         if(!readback[slot].Pending()) return;
+                         std::vector<unsigned char> pixels(4*width*height);
+                         readback[slot].Map(pixels.data());
+                         writer.Write(std::move(pixels), width, height, names[slot]);
+                       };
+
+    //The list of events is rendered by going to each event after the first one is loaded.  The first event has to be
+    //loaded anyway to draw the geometry.
+    const bool useList = !batch.fEvents.empty();
+    size_t nQueued = 0; //Events from batch.fEvents that have been sent to the event cache
+    if(useList)
+    {
+      evd.NextEventStatus().wait();
+      evd.LoadNextEvent();
+    }
+
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    clock::duration renderTime = clock::duration::zero(), waitTime = clock::duration::zero();
+    while(nRendered < batch.fMaxEvents && (!useList || nRendered < batch.fEvents.size()))
+    {
+      //Keep the event cache full like fsm::Running does
+      const auto queueNext = [&]()
+                             {
+                               if(!useList) evd.ProcessEvent(false);
+                               else if(nQueued < batch.fEvents.size())
+                               {
+                                 evd.ProcessEvent(batch.fEvents[nQueued].first, batch.fEvents[nQueued].second);
+                                 ++nQueued;
+                               }
+                             };
+      if(evd.EventCacheSize() == 0) queueNext();
+      else if(evd.EventCacheSize() < evd.MaxEventCacheSize()
+              && evd.LastEventStatus().wait_for(std::chrono::seconds(0)) == std::future_status::ready) queueNext();
+      if(evd.EventCacheSize() == 0) break; //Nothing left in the list
+
+      const auto waitStart = clock::now();
+      try
+      {
+        evd.NextEventStatus().wait();
+        evd.LoadNextEvent();
+      }
+      catch(const src::Source::no_more_files& e)
+      {
+        //An event that isn't in the Source and the end of the Source look the same
+        evd.ClearCache();
+        if(!useList) break;
+        std::cerr << "Skipping event " << nRendered << " in the event list because it isn't in any input file.\n";
+        batch.fEvents.erase(batch.fEvents.begin() + nRendered);
+        nQueued = nRendered; //Events that were already queued were cleared too
+        continue;
+      }
+      const auto renderStart = clock::now();
+      waitTime += renderStart - waitStart;
+
+      if(!batch.fCamera.empty()) evd.SetCamera(batch.fCamera);
+
+      target.Use();
+      glViewport(0, 0, width, height);
+      evd.RenderScenes(width, height);
+
+      const size_t slot = nRendered % readback.size();
+      flush(slot); //Event from readback.size() events ago
+      readback[slot].Read(0, 0, width, height, GL_BGRA, GL_UNSIGNED_BYTE, 4*width*height);
+      names[slot] = batch.fOutput + "/" + evd.ImageName(batch.fFormat);
+      mygl::Framebuffer::Default();
+
+      renderTime += clock::now() - renderStart;
+      ++nRendered;
+      if(nRendered % 100 == 0) std::cout << "Rendered " << nRendered << " events\n";
+    }
+
+    for(size_t slot = 0; slot < readback.size(); ++slot) flush((nRendered + slot) % readback.size()); //Oldest first
+    writer.Wait();
+
+    const double seconds = std::chrono::duration<double>(clock::now() - start).count();
+    const auto perEvent = [nRendered](const clock::duration time)
+                          {
+                            return std::chrono::duration<double, std::milli>(time).count()/std::max<size_t>(1, nRendered);
+                          };
+    std::cout << "Rendered " << nRendered << " events to " << batch.fOutput << " in " << seconds << " s: "
+              << nRendered/std::max(seconds, 1e-9) << " events/second\n"
+              << "Per event: " << perEvent(waitTime) << " ms waiting for the event cache, " << perEvent(renderTime)
+              << " ms rendering\n";
+  }
+  catch(const std::exception& e)
+  {
+    std::cerr << "EvdBatch failed after " << nRendered << " events:\n" << e.what() << "\n";
+    mygl::Profiler::Instance().ReleaseGPU();
+    glfwDestroyWindow(context);
+    glfwTerminate();
+    return 1;
+  }
+
+  mygl::Profiler::Instance().ReleaseGPU(); //Scenes record GPU timings even though nobody looks at them here
+  glfwDestroyWindow(context);
+  glfwTerminate();
+  return 0;
+}
@@ -19,9 +19,59 @@
 
 //local include
 #include "Controller.h"
+#include "gl/Profiler.h"
+
+//ROOT includes
+#include "TROOT.h" //For ROOT::EnableThreadSafety()
+
+namespace
+{
+  //Frames are only drawn when something might have changed.  Dear imgui needs a few frames after each input to finish 
+  //reacting to it, so every input draws framesAfterInput frames.
+  constexpr int framesAfterInput = 3;
+  int framesToDraw = framesAfterInput; //Frames left to draw before waiting for input again
+
+  //While waiting for input, wake up this often to check on events and histograms being made in the background
+  constexpr double pollSeconds = 0.05;
+
+  //Forward input to Dear imgui and remember to draw new frames
+  void onMouseButton(GLFWwindow* window, int button, int action, int mods)
+  {
+    ImGui_ImplGlfw_MouseButtonCallback(window, button, action, mods);
+    framesToDraw = framesAfterInput;
+  }
+
+  void onScroll(GLFWwindow* window, double xOffset, double yOffset)
+  {
+    ImGui_ImplGlfw_ScrollCallback(window, xOffset, yOffset);
+    framesToDraw = framesAfterInput;
+  }
+
+  void onKey(GLFWwindow* window, int key, int scancode, int action, int mods)
+  {
+    ImGui_ImplGlfw_KeyCallback(window, key, scancode, action, mods);
+    framesToDraw = framesAfterInput;
+  }
+
+  void onChar(GLFWwindow* window, unsigned int c)
+  {
+    ImGui_ImplGlfw_CharCallback(window, c);
+    framesToDraw = framesAfterInput;
+  }
+
+  //Dear imgui reads the mouse position itself, but moving the mouse can still change hover effects and the Camera
+  void onCursorPos(GLFWwindow*, double, double) { framesToDraw = framesAfterInput; }
+  void onResize(GLFWwindow*, int, int) { framesToDraw = framesAfterInput; }
+  void onRefresh(GLFWwindow*) { framesToDraw = framesAfterInput; }
+  void onFocus(GLFWwindow*, int) { framesToDraw = framesAfterInput; }
+}
 
 int main(const int argc, const char** argv)
 {
+  //evd::Window reads events on other threads, and Print writes images with ROOT on another thread.  ROOT has to know
+  //about this before any of them starts.
+  ROOT::EnableThreadSafety();
+
   //glfwSetErrorCallback(error_callback); //TODO: Throw exception here?  
   if (!glfwInit())
       return 1;
@@ -44,7 +94,15 @@ int main(const int argc, const char** argv)
   ImGui::CreateContext();
   ImGuiIO& io = ImGui::GetIO(); 
 
-  ImGui_ImplGlfwGL3_Init(window, true);
+  ImGui_ImplGlfwGL3_Init(window, false); //The callbacks below forward input to Dear imgui
+  glfwSetMouseButtonCallback(window, onMouseButton);
+  glfwSetScrollCallback(window, onScroll);
+  glfwSetKeyCallback(window, onKey);
+  glfwSetCharCallback(window, onChar);
+  glfwSetCursorPosCallback(window, onCursorPos);
+  glfwSetFramebufferSizeCallback(window, onResize);
+  glfwSetWindowRefreshCallback(window, onRefresh);
+  glfwSetWindowFocusCallback(window, onFocus);
   io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;  // Enable Keyboard Controls
   io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;   // Enable Gamepad Controls
   //io.ConfigFlags |= ImGuiConfigFlags_MoveMouse; //Enable mouse movement
@@ -63,6 +121,7 @@ int main(const int argc, const char** argv)
   //has been run.  If this is causing problems for you, try running "root -l" and waiting for it to finish before you 
   //run edepViewer after a new login.
   evd::Controller evd(argc, argv);
+  auto& profiler = mygl::Profiler::Instance();
 
   //Rendering loop.  Needs to depend on library providing the opengl context/window.
   while (!glfwWindowShouldClose(window))
@@ -72,26 +131,46 @@ int main(const int argc, const char** argv)
     // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application.
     // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application.
     // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
-    glfwPollEvents(); //TODO: Since this is an event viewer rather than a game, use glfwWaitEvents() instead?
+    //Render on demand: this is an event viewer rather than a game, so don't keep a core busy redrawing the same frame.  
+    //Wait for input unless something else changed.
+    if(framesToDraw > 0 || evd.NeedsFrame() || profiler.NeedsFrame()) glfwPollEvents();
+    else
+    {
+      glfwWaitEventsTimeout(pollSeconds);
+      if(framesToDraw == 0 && !evd.NeedsFrame()) continue;
+    }
+    if(framesToDraw > 0) --framesToDraw;
+
+    profiler.BeginFrame();
     ImGui_ImplGlfwGL3_NewFrame();
   
     int display_w, display_h;
     glfwGetFramebufferSize(window, &display_w, &display_h);
     glViewport(0, 0, display_w, display_h);
   
-    evd.Render(display_w, display_h, io);
+    {
+      mygl::Profiler::Scope timer("Controller::Render");
+      evd.Render(display_w, display_h, io);
+    }
  
-    #ifndef NDEBUG
-    bool showMetrics = true;
-    ImGui::ShowMetricsWindow(&showMetrics);
-    #endif
+    profiler.Render(); //Press F2 for timing information.  Also has a checkbox for ImGui::ShowMetricsWindow().
   
-    ImGui::Render();
-    ImGui_ImplGlfwGL3_RenderDrawData(ImGui::GetDrawData());
-    glfwSwapBuffers(window);
+    {
+      mygl::Profiler::Scope cpuTimer("Dear imgui");
+      mygl::Profiler::GPUScope gpuTimer("Dear imgui");
+      ImGui::Render();
+      ImGui_ImplGlfwGL3_RenderDrawData(ImGui::GetDrawData());
+    }
+
+    {
+      mygl::Profiler::Scope timer("SwapBuffers"); //Includes waiting for vsync
+      glfwSwapBuffers(window);
+    }
+    profiler.EndFrame();
   }
 
   // Cleanup
+  profiler.ReleaseGPU();
   ImGui_ImplGlfwGL3_Shutdown();
   ImGui::DestroyContext();
   glfwTerminate();
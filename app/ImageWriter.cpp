@@ -0,0 +1,88 @@
+//File: ImageWriter.cpp
+//Brief: Encodes images on worker threads with ROOT's interface to AfterImage.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//local includes
+#include "app/ImageWriter.h"
+
+//ROOT includes
+#include "TASImage.h"
+
+//c++ includes
+#include <iostream>
+#include <algorithm>
+
+namespace evd
+{
+  ImageWriter::ImageWriter(const size_t nThreads, const size_t maxQueued): fMaxQueued(std::max<size_t>(1, maxQueued)),
+                                                                           fInProgress(0), fWritten(0), fStopping(false)
+  {
+    for(size_t thread = 0; thread < std::max<size_t>(1, nThreads); ++thread) fThreads.emplace_back(&ImageWriter::Work, this);
+  }
+
+  ImageWriter::~ImageWriter()
+  {
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fStopping = true;
+    }
+    fQueueChanged.notify_all();
+    for(auto& thread: fThreads) thread.join();
+  }
+
+  void ImageWriter::Write(std::vector<unsigned char>&& pixels, const int width, const int height, const std::string& fileName)
+  {
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fQueueChanged.wait(lock, [this]() { return fQueue.size() < fMaxQueued; });
+      fQueue.push_back(Image{std::move(pixels), width, height, fileName});
+    }
+    fQueueChanged.notify_all();
+  }
+
+  void ImageWriter::Wait()
+  {
+    std::unique_lock<std::mutex> lock(fMutex);
+    fImageDone.wait(lock, [this]() { return fQueue.empty() && fInProgress == 0; });
+  }
+
+  size_t ImageWriter::Pending()
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    return fQueue.size() + fInProgress;
+  }
+
+  size_t ImageWriter::Written()
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    return fWritten;
+  }
+
+  void ImageWriter::Work()
+  {
+    std::unique_lock<std::mutex> lock(fMutex);
+    while(true)
+    {
+      fQueueChanged.wait(lock, [this]() { return !fQueue.empty() || fStopping; });
+      if(fQueue.empty()) return; //fStopping and nothing left to write
+
+      auto image = std::move(fQueue.front());
+      fQueue.pop_front();
+      ++fInProgress;
+      lock.unlock();
+      fQueueChanged.notify_all(); //Make room for Write()
+
+      //Use ROOT's interface to AfterImage for now to keep dependencies down.  FromGLBuffer() flips the image because
+      //OpenGL's rows start at the bottom.
+      TASImage encoder;
+      encoder.FromGLBuffer(image.fPixels.data(), image.fWidth, image.fHeight);
+      encoder.WriteImage(image.fFileName.c_str());
+      if(!encoder.IsValid()) std::cerr << "Failed to make an image to write to " << image.fFileName << "\n";
+
+      lock.lock();
+      --fInProgress;
+      ++fWritten;
+      fImageDone.notify_all();
+    }
+  }
+}
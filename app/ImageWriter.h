@@ -0,0 +1,59 @@
+//File: ImageWriter.h
+//Brief: An ImageWriter encodes pixels read back from OpenGL into image files on its own threads so that rendering
+//       doesn't have to wait for compression or disk access.  Write() returns as soon as the pixels are queued unless
+//       too many images are already waiting.  The image format comes from the file name's extension and can be anything
+//       that ROOT's TASImage can write: png, jpg, gif, tiff, bmp, xpm...  Call ROOT::EnableThreadSafety() before any 
+//       thread uses ROOT, which means before the first ImageWriter or evd::Window is created.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef EVD_IMAGEWRITER_H
+#define EVD_IMAGEWRITER_H
+
+//c++ includes
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace evd
+{
+  class ImageWriter
+  {
+    public:
+      //nThreads images are encoded at the same time.  Write() blocks while maxQueued images are waiting.
+      ImageWriter(const size_t nThreads = 1, const size_t maxQueued = 8);
+      virtual ~ImageWriter(); //Finishes every image that was queued
+
+      //Write width x height BGRA pixels, bottom row first like glReadPixels() returns them, to fileName
+      void Write(std::vector<unsigned char>&& pixels, const int width, const int height, const std::string& fileName);
+
+      void Wait(); //Block until every queued image has been written
+      size_t Pending(); //Number of images queued or being written
+      size_t Written(); //Number of images written so far
+
+    private:
+      struct Image
+      {
+        std::vector<unsigned char> fPixels;
+        int fWidth;
+        int fHeight;
+        std::string fFileName;
+      };
+
+      void Work(); //Body of each thread in fThreads
+
+      std::mutex fMutex; //Protects everything below
+      std::condition_variable fQueueChanged; //Signaled when an Image is added to or removed from fQueue
+      std::condition_variable fImageDone; //Signaled when a thread finishes writing an Image
+      std::deque<Image> fQueue; //Images waiting for a thread
+      size_t fMaxQueued; //Largest that fQueue can get
+      size_t fInProgress; //Images being written right now
+      size_t fWritten; //Images finished
+      bool fStopping; //Tells threads to exit once fQueue is empty
+      std::vector<std::thread> fThreads;
+  };
+}
+
+#endif //EVD_IMAGEWRITER_H
@@ -13,6 +13,9 @@
 #include "gl/camera/PlaneCam.h"
 //#include "gl/objects/Texture2D.cpp"
 
+//util includes
+#include "util/PDGNames.h"
+
 
 //Load plugins for drawing from Factory
 #include "plugins/Factory.cpp"
@@ -21,16 +24,19 @@
 #include <glm/gtc/type_ptr.hpp>
 
 //ROOT includes
-#include "TDatabasePDG.h"
-#include "TParticlePDG.h"
-#include "TASImage.h" //For writing images to a file
+#include "TSystem.h" //For making the Print directory
+
+//c++ includes
+#include <algorithm>
+#include <cstring>
 
 namespace
 {
   //Shortcut for loading all plugins of type BASE from a YAML node's name element.  Throws std::runtime_error if 
-  //pluginConfig[name] doesn't exist.
+  //pluginConfig[name] doesn't exist.  The name of each plugin loaded is appended to names.
   template <class BASE>
-  void loadPlugins(const YAML::Node& pluginConfig, const std::string& name, std::vector<std::unique_ptr<BASE>>& plugins)
+  void loadPlugins(const YAML::Node& pluginConfig, const std::string& name, std::vector<std::unique_ptr<BASE>>& plugins, 
+                   std::vector<std::string>& names)
   {
     auto& factory = plgn::Factory<BASE>::instance();
     if(pluginConfig[name])
@@ -39,21 +45,49 @@ namespace
       for(auto plugin = config.begin(); plugin != config.end(); ++plugin)
       {
         auto drawer = factory.Get(plugin->first.as<std::string>(), plugin->second);
-        if(drawer != nullptr) plugins.push_back(std::move(drawer));
+        if(drawer != nullptr)
+        {
+          plugins.push_back(std::move(drawer));
+          names.push_back(plugin->first.as<std::string>());
+        }
         else std::cerr << "Failed to get " << name << " plugin named " << plugin->first << "(end)\n";
       }
     }
     else throw std::runtime_error("Failed to get an element named "+name+" from config.yaml.\n");
   }
+
+  //Image formats the user can Print to.  Anything that TASImage can write would work.
+  const char* imageFormats[] = {"png", "jpg", "gif", "tiff", "bmp"};
+  constexpr int nImageFormats = sizeof(imageFormats)/sizeof(imageFormats[0]);
+  constexpr int maxPrintScale = 8;
+
+  //Copy a std::string into a fixed-size buffer for Dear imgui.  Truncates if needed.
+  template <size_t N>
+  void copyString(const std::string& source, char (&dest)[N])
+  {
+    std::strncpy(dest, source.c_str(), N-1);
+    dest[N-1] = '\0';
+  }
+
+  void replaceAll(std::string& text, const std::string& token, const std::string& value)
+  {
+    for(auto pos = text.find(token); pos != std::string::npos; pos = text.find(token, pos + value.size()))
+    {
+      text.replace(pos, token.size(), value);
+    }
+  }
 }
 
 namespace evd
 {
   Window::Window(std::unique_ptr<YAML::Node>&& config, std::unique_ptr<src::Source>&& source): fConfig(new YAML::Node()),
                  fMaxEventCacheSize(5), fViewer(std::unique_ptr<mygl::Camera>(new mygl::PlaneCam(glm::vec3(0., 0., 1000.), glm::vec3(0., 0., -1.), glm::vec3(0.0, 1.0, 0.0), 10000., 100.)), 10., 10., 10.),
-    fSource(), fServices(), fCurrentEvent(std::numeric_limits<int>::min(), std::numeric_limits<int>::min(), "DEFAULT", false)
-    //, fPrintTexture(nullptr)
+    fSource(), fPrintWriter(), fPrintTarget(), fTiles(), fPrintRequested(false), fPrintWidth(0), fPrintHeight(0), fPrintFile(),
+    fShowPrintSettings(false), fPrintFormat(0), fPrintScale(1), fNPrinted(0), fPrintStatus(), fServices(), 
+    fNeedsFrame(true), fDrawnCacheStatus(), fEventCache(), fEventRecords(), fCurrentEvent(std::numeric_limits<int>::min(), std::numeric_limits<int>::min(), "DEFAULT", false)
   {
+    copyString("{file}_run{run}_evt{event}", fPrintName);
+    copyString(".", fPrintDirectory);
     reconfigure(std::move(config));
     SetSource(std::move(source));
   }
@@ -76,13 +110,30 @@ namespace evd
       //Load global plugins
       const auto& top = *fConfig;
       const auto& drawers = top["Drawers"];
-      ::loadPlugins(drawers, "Global", fGlobalDrawers); //TODO: If this works, replace all other plugin-loading loops
+      ::loadPlugins(drawers, "Global", fGlobalDrawers, fGlobalNames); //TODO: If this works, replace all other plugin-loading loops
 
       //Load event plugins
-      ::loadPlugins(drawers, "Event", fEventDrawers);
+      ::loadPlugins(drawers, "Event", fEventDrawers, fEventNames);
       
       //Load camera config plugins
-      ::loadPlugins(drawers, "Camera", fCameraConfigs);
+      std::vector<std::string> cameraNames; //Cameras are timed all together
+      ::loadPlugins(drawers, "Camera", fCameraConfigs, cameraNames);
+
+      //Optional defaults for the Print Settings window
+      if(top["Print"])
+      {
+        const auto& print = top["Print"];
+        if(print["Format"])
+        {
+          const auto format = print["Format"].as<std::string>();
+          const auto found = std::find(imageFormats, imageFormats + nImageFormats, format);
+          if(found == imageFormats + nImageFormats) throw util::GenException("Print Format") << "Can't print images in format " << format << ".\n";
+          fPrintFormat = found - imageFormats;
+        }
+        if(print["Scale"]) fPrintScale = std::max(1, std::min(maxPrintScale, print["Scale"].as<int>()));
+        if(print["Name"]) copyString(print["Name"].as<std::string>(), fPrintName);
+        if(print["Directory"]) copyString(print["Directory"].as<std::string>(), fPrintDirectory);
+      }
 
       //Load external plugins
       /*auto& extFactory = plgn::Factory<draw::ExternalDrawer>::instance();
@@ -116,6 +167,8 @@ namespace evd
 
   void Window::ReadGeo()
   {
+    mygl::Profiler::Scope timer("ReadGeo");
+
     //Load service information
     const auto& serviceConfig = (*fConfig)["Services"]; 
     if(!serviceConfig) std::cerr << "Couldn't find services block.\n";
@@ -126,7 +179,11 @@ namespace evd
     auto man = fSource->Geo();
 
     //Next, create threads to do "drawing".  These functions shouldn't modify OpenGL state.  
-    for(const auto& drawPtr: fGlobalDrawers) drawPtr->Draw(*man, fServices);
+    for(size_t drawer = 0; drawer < fGlobalDrawers.size(); ++drawer)
+    {
+      mygl::Profiler::Scope timer("Draw " + fGlobalNames[drawer]);
+      fGlobalDrawers[drawer]->Draw(*man, fServices);
+    }
   }
 
   void Window::ReadEvent()
@@ -134,7 +191,16 @@ namespace evd
     //Now, DrawEvents(), which makes no OpenGL calls, can be run in parallel.  
     const auto& evt = fSource->Event();
 
-    for(const auto& drawer: fEventDrawers) drawer->Draw(evt, fServices);
+    //These belong to the last event
+    fServices.fEventView.reset();
+    fServices.fTopology.reset();
+    for(size_t drawer = 0; drawer < fEventDrawers.size(); ++drawer)
+    {
+      mygl::Profiler::Scope timer("Draw " + fEventNames[drawer]);
+      fEventDrawers[drawer]->Draw(evt, fServices);
+    }
+
+    mygl::Profiler::Scope timer("MakeCameras");
     for(const auto& config: fCameraConfigs) config->MakeCameras(evt, fServices);
 
     /*fExternalFuture = std::async(std::launch::async, [this, &evt, &id]()
@@ -155,30 +221,137 @@ namespace evd
     /*for(const auto& extPtr: fExtDrawers) extPtr->RequestScene(fViewer);*/
   }
   
-  void Window::Print(const int width, const int height)
+  void Window::Print()
   {
-    //I learned to do this from the SOIL library:
-    //https://github.com/kbranigan/Simple-OpenGL-Image-Library/blob/master/src/SOIL.c
-    auto data = new unsigned char[4*width*height];
-    glReadPixels(0, 0, width, height, GL_BGRA, GL_UNSIGNED_BYTE, data); //For some reason, I need to use BGR instead of RGB.  
-                                                                        //Maybe PNG-specific: https://stackoverflow.com/questions/5123387/loading-a-bmp-into-an-opengl-textures-switches-the-red-and-blue-colors-c-win
-
-    //Use ROOT's interface to AfterImage for now to keep dependencies down.  
-    //Maybe write optional plugins for other libraries in the future?  Maybe libpng which is supposed to 
-    //have Emscripten support?
-    TASImage screenshot;
-    screenshot.FromGLBuffer(data, width, height);
-    const auto file = fCurrentEvent.fileName;
-    const std::string fileBase = file.substr(file.find_last_of("/")+1, file.find_first_of(".")-1);
-    screenshot.WriteImage((fileBase+"_run"+std::to_string(fCurrentEvent.runID)+"_evt"+std::to_string(fCurrentEvent.eventID)+".png").c_str()); 
-    //TODO: Let user pick name and image type
-
-    delete[] data; //Free image data now that I am done with it
-
-    //fPrintTexture.reset(new mygl::Texture2D(, , nullptr));
+    fPrintRequested = true; //Drawn in the next Render() once the Scenes are up to date
+  }
+
+  void Window::StartPrint(const int width, const int height)
+  {
+    mygl::Profiler::Scope timer("StartPrint");
+    fPrintRequested = false;
+    fPrintWidth = fPrintScale*width;
+    fPrintHeight = fPrintScale*height;
+    fPrintFile = std::string(fPrintDirectory) + "/" + ImageName(imageFormats[fPrintFormat]);
+    ++fNPrinted;
+
+    //Each Tile is the size of the window unless OpenGL can't draw that many pixels at once
+    //fPrintTarget's color attachment is a texture and its depth attachment is a renderbuffer.
+    GLint maxViewport[2], maxRenderbuffer, maxTexture;
+    glGetIntegerv(GL_MAX_VIEWPORT_DIMS, maxViewport);
+    glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &maxRenderbuffer);
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTexture);
+    const int maxAttachment = std::min((int)maxRenderbuffer, (int)maxTexture);
+    const int tileWidth = std::min({width, (int)maxViewport[0], maxAttachment}),
+              tileHeight = std::min({height, (int)maxViewport[1], maxAttachment});
+
+    fPrintTarget.Resize(tileWidth, tileHeight);
+    fPrintTarget.Use();
+    for(int y = 0; y < fPrintHeight; y += tileHeight)
+    {
+      for(int x = 0; x < fPrintWidth; x += tileWidth)
+      {
+        Tile tile{x, y, std::min(tileWidth, fPrintWidth - x), std::min(tileHeight, fPrintHeight - y), 
+                  std::unique_ptr<mygl::PixelBuffer>(new mygl::PixelBuffer())};
+        glViewport(0, 0, tile.fWidth, tile.fHeight);
+        fViewer.RenderTile(fPrintWidth, fPrintHeight, x, y, tile.fWidth, tile.fHeight);
+        //For some reason, I need to use BGR instead of RGB.  Maybe PNG-specific: https://stackoverflow.com/questions/5123387/loading-a-bmp-into-an-opengl-textures-switches-the-red-and-blue-colors-c-win
+        tile.fPixels->Read(0, 0, tile.fWidth, tile.fHeight, GL_BGRA, GL_UNSIGNED_BYTE, 4ul*tile.fWidth*tile.fHeight);
+        fTiles.push_back(std::move(tile));
+      }
+    }
+    mygl::Framebuffer::Default();
+    glViewport(0, 0, width, height);
+  }
+
+  void Window::FinishPrint()
+  {
+    if(fTiles.empty()) return;
+    for(auto& tile: fTiles) if(!tile.fPixels->Ready()) return; //Try again next frame
+
+    mygl::Profiler::Scope timer("FinishPrint");
+    std::vector<unsigned char> image(4ul*fPrintWidth*fPrintHeight);
+    if(fTiles.size() == 1) fTiles.front().fPixels->Map(image.data());
+    else
+    {
+      //Copy each row of each Tile into the image.  Rows start at the bottom like in glReadPixels().
+      std::vector<unsigned char> pixels;
+      for(auto& tile: fTiles)
+      {
+        pixels.resize(4ul*tile.fWidth*tile.fHeight);
+        tile.fPixels->Map(pixels.data());
+        for(int row = 0; row < tile.fHeight; ++row)
+        {
+          std::copy(pixels.begin() + 4ul*row*tile.fWidth, pixels.begin() + 4ul*(row+1)*tile.fWidth, 
+                    image.begin() + 4ul*((size_t)(tile.fY + row)*fPrintWidth + tile.fX));
+        }
+      }
+    }
+    fTiles.clear();
+
+    //Encoding and writing large images takes a long time, so do it on another thread
+    if(!fPrintWriter) fPrintWriter.reset(new ImageWriter());
+    gSystem->mkdir(fPrintDirectory, true); //Does nothing if the directory already exists
+    fPrintWriter->Write(std::move(image), fPrintWidth, fPrintHeight, fPrintFile);
+    fPrintStatus = "Printed " + fPrintFile + " (" + std::to_string(fPrintWidth) + " x " + std::to_string(fPrintHeight) + ")";
+
     //TODO: Render to a 3D texture (have to sample each z "layer" individually), and write that to a u3d file?
   }
 
+  void Window::RenderPrintSettings(const int width, const int height)
+  {
+    if(!fShowPrintSettings) return;
+
+    ImGui::Begin("Print Settings", &fShowPrintSettings);
+    ImGui::Combo("Format", &fPrintFormat, imageFormats, nImageFormats);
+    ImGui::SliderInt("Scale", &fPrintScale, 1, maxPrintScale);
+    fPrintScale = std::max(1, std::min(maxPrintScale, fPrintScale)); //In case the user typed a value
+    if(ImGui::IsItemHovered()) ImGui::SetTooltip("Print images this many times as wide and as tall as the window.\n"
+                                                 "They are drawn in tiles, so they can be larger than the screen.");
+    ImGui::InputText("Name", fPrintName, sizeof(fPrintName));
+    if(ImGui::IsItemHovered()) ImGui::SetTooltip("{file}, {run}, {event}, and {n} are replaced with the input file name, run\n"
+                                                 "number, event number, and number of images printed so far.");
+    ImGui::InputText("Directory", fPrintDirectory, sizeof(fPrintDirectory));
+
+    ImGui::Separator();
+    ImGui::Text("Next image: %s/%s", fPrintDirectory, ImageName(imageFormats[fPrintFormat]).c_str());
+    ImGui::Text("%d x %d pixels", fPrintScale*width, fPrintScale*height);
+    if(!fPrintStatus.empty()) ImGui::TextWrapped("%s", fPrintStatus.c_str());
+    if(fPrintWriter && fPrintWriter->Pending() > 0) ImGui::Text("Writing %lu image(s)...", (unsigned long)fPrintWriter->Pending());
+    if(ImGui::Button("Print")) Print();
+    ImGui::End();
+  }
+
+  std::string Window::ImageName(const std::string& extension) const
+  {
+    const auto& file = fCurrentEvent.fileName;
+    const auto start = file.find_last_of("/") + 1; //0 if there's no directory
+    const std::string fileBase = file.substr(start, file.find_first_of(".", start) - start);
+
+    std::string name(fPrintName);
+    replaceAll(name, "{file}", fileBase);
+    replaceAll(name, "{run}", std::to_string(fCurrentEvent.runID));
+    replaceAll(name, "{event}", std::to_string(fCurrentEvent.eventID));
+    replaceAll(name, "{n}", std::to_string(fNPrinted));
+    return name + "." + extension;
+  }
+
+  void Window::RenderScenes(const int width, const int height)
+  {
+    fViewer.RenderScenes(width, height);
+  }
+
+  void Window::SetCamera(const std::string& name)
+  {
+    fViewer.SetCamera(name);
+  }
+
+  void Window::SetCut(const std::string& sceneName, const std::string& cut)
+  {
+    fViewer.SetCut(sceneName, cut);
+    fNeedsFrame = true;
+  }
+
   void Window::Render(const int width, const int height, const ImGuiIO& ioState)
   {
       //Pop up file selection GUI and call reconfigure()
@@ -199,28 +372,49 @@ namespace evd
       }*/
 
     //Pop up legend of particle colors used
-    auto db = TDatabasePDG::Instance();
     ImGui::Begin("Legend");
     for(auto& pdg: *(fServices.fPDGToColor))
     {
-      const auto particle = db->GetParticle(pdg.first);
-      std::string name;
-      if(particle) name = particle->GetName();
-      else name = std::to_string(pdg.first);
-          
-      ImGui::ColorEdit3(name.c_str(), glm::value_ptr(pdg.second), ImGuiColorEditFlags_NoInputs);
+      ImGui::ColorEdit3(util::PDGName(pdg.first).c_str(), glm::value_ptr(pdg.second), ImGuiColorEditFlags_NoInputs);
     }
     ImGui::End();
 
+    fNeedsFrame = false;
+    fDrawnCacheStatus = CacheStatus();
     fViewer.Render(width, height, ioState);
+
+    //Print once the Scenes are up to date for this frame
+    FinishPrint();
+    if(fPrintRequested && fTiles.empty()) StartPrint(width, height);
+    RenderPrintSettings(width, height);
+  }
+
+  bool Window::NeedsFrame() const
+  {
+    if(fNeedsFrame || fPrintRequested || !fTiles.empty() || fViewer.NeedsFrame()) return true;
+    return CacheStatus() != fDrawnCacheStatus;
+  }
+
+  std::tuple<size_t, bool, bool> Window::CacheStatus() const
+  {
+    if(fEventCache.empty()) return std::make_tuple(size_t(0), false, false);
+
+    const auto ready = [](const std::future<src::Source::metadata>& status)
+                       {
+                         return status.valid() && status.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+                       };
+    return std::make_tuple(fEventCache.size(), ready(fEventCache.front()), ready(fEventCache.back()));
   }
 
   void Window::ProcessEvent(const bool forceGeo)
   {
+    const auto record = mygl::Profiler::Instance().QueueEvent();
+    fEventRecords.push(record);
     fEventCache.push(std::async(std::launch::async,
-                                [this, forceGeo]()
+                                [this, forceGeo, record]()
                                 {
-                                  const auto meta = fSource->Next();
+                                  mygl::Profiler::EventScope timing(record);
+                                  const auto meta = [this]() { mygl::Profiler::Scope timer("Source::Next"); return fSource->Next(); }();
                                   if(meta.newFile || forceGeo) ReadGeo();
                                   ReadEvent();
                                   return meta;
@@ -229,10 +423,17 @@ namespace evd
 
   void Window::ProcessEvent(const int run, const int event)
   {
+    const auto record = mygl::Profiler::Instance().QueueEvent();
+    fEventRecords.push(record);
     fEventCache.push(std::async(std::launch::async,
-                                [this, run, event]()
+                                [this, run, event, record]()
                                 {
-                                  const auto meta = fSource->GoTo(run, event);
+                                  mygl::Profiler::EventScope timing(record);
+                                  const auto meta = [this, run, event]() 
+                                                    { 
+                                                      mygl::Profiler::Scope timer("Source::GoTo"); 
+                                                      return fSource->GoTo(run, event); 
+                                                    }();
                                   if(meta.newFile) ReadGeo();
                                   ReadEvent();
                                   return meta;
@@ -240,26 +441,46 @@ namespace evd
   }
 
   //fNextEvent must be valid before calling this function
-  void Window::LoadNextEvent()
+  void Window::LoadNextEvent(const mygl::Profiler::clock::time_point requested)
   {
+    auto& profiler = mygl::Profiler::Instance();
+    const auto record = fEventRecords.front();
+    fEventRecords.pop();
+    mygl::Profiler::EventScope timing(record);
+
     //Any exceptions from the thread where fNextEvent was "created" will be thrown when I 
     //call fNextEvent.get().  I particularly want to react to no_more_files exceptions.  
     //If I don't get a next event, don't load anything.
     const auto meta = fEventCache.front().get();
     fEventCache.pop(); //Now that we're displaying this event, it's no longer in the cache of events to display in the future
                        //TODO: Move current event to previous event position
+    profiler.AddStage(record, "Wait for event", requested, mygl::Profiler::clock::now()); //Not CPU time, so not a Scope
     fCurrentEvent = meta; //Assignment on a separate line because I'm afraid of meta getting assigned when fNextEvent throws
-    mygl::VisID id(0, 0, 0);
+    mygl::VisID id;
     if(fCurrentEvent.newFile)
     {
-      for(const auto& geo: fGlobalDrawers) geo->UpdateScene(id);
+      for(size_t geo = 0; geo < fGlobalDrawers.size(); ++geo)
+      {
+        mygl::Profiler::Scope timer("UpdateScene " + fGlobalNames[geo]);
+        fGlobalDrawers[geo]->UpdateScene(id);
+      }
+    }
+    for(size_t drawer = 0; drawer < fEventDrawers.size(); ++drawer)
+    {
+      mygl::Profiler::Scope timer("UpdateScene " + fEventNames[drawer]);
+      fEventDrawers[drawer]->UpdateScene(id);
     }
-    for(const auto& drawer: fEventDrawers) drawer->UpdateScene(id);
     
-    std::map<std::string, std::unique_ptr<mygl::Camera>> cameras;
-    for(const auto& config: fCameraConfigs) config->AppendCameras(cameras);
-    fViewer.LoadCameras(std::move(cameras));
+    {
+      mygl::Profiler::Scope timer("LoadCameras");
+      std::map<std::string, std::unique_ptr<mygl::Camera>> cameras;
+      for(const auto& config: fCameraConfigs) config->AppendCameras(cameras);
+      fViewer.LoadCameras(std::move(cameras));
+    }
     //TODO: UpdateScene() for ExternalDrawers as well
+
+    profiler.FinishEvent(record, fCurrentEvent.runID, fCurrentEvent.eventID);
+    fNeedsFrame = true; //The States call this after Render(), so draw the new event in the next frame
   }
 
   void Window::ClearCache()
@@ -269,6 +490,7 @@ namespace evd
     for(auto& cam: fCameraConfigs) cam->Clear();
 
     fEventCache = std::queue<std::future<src::Source::metadata>>();
+    fEventRecords = std::queue<std::shared_ptr<mygl::Profiler::EventRecord>>();
   }
 
   std::future<src::Source::metadata>& Window::NextEventStatus()
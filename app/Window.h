@@ -13,9 +13,11 @@
 
 //local includes
 #include "app/Source.h"
+#include "app/ImageWriter.h"
 
 //gl includes
 #include "gl/Viewer.h"
+#include "gl/Profiler.h"
 #include "gl/metadata/Column.cpp"
 
 //ROOT includes
@@ -34,6 +36,7 @@
 
 //c++ includes
 #include <future>
+#include <tuple>
 
 #ifndef EVD_WINDOW
 #define EVD_WINDOW
@@ -63,12 +66,22 @@ namespace evd
       //Control event processing
       void ProcessEvent(const bool forceGeo);  //Process the next event in the current Source
       void ProcessEvent(const int run, const int event); //Process a specific event from the current Source
-      void LoadNextEvent(); //Load the first event in fEventCache as the event the user is viewing
+      //Load the first event in fEventCache as the event the user is viewing.  requested is when the user asked to see it.
+      void LoadNextEvent(const mygl::Profiler::clock::time_point requested = mygl::Profiler::clock::now());
       void ClearCache(); //Empty fEventCache.  Useful in preparation for a non-sequential event access
       void SetSource(std::unique_ptr<src::Source>&& source); //Set the Source from which future events will be read
 
       //Functions that can be called at any time
-      void Print(const int width, const int height); //Print the current window to a file
+      //Print the Scenes to a file as configured in the Print Settings window.  The image is drawn in the next Render() 
+      //and written on another thread a few frames later, so Print() never waits for the GPU or the disk.
+      void Print();
+      std::string ImageName(const std::string& extension) const; //Print Settings' name pattern with extension.  <input file>_run<run>_evt<event> by default.
+      bool& ShowPrintSettings() { return fShowPrintSettings; } //Is the Print Settings window visible?
+
+      //Batch rendering without a user.  See mygl::Viewer.  SetCamera() needs to be called again after each LoadNextEvent().
+      void RenderScenes(const int width, const int height);
+      void SetCamera(const std::string& name);
+      void SetCut(const std::string& sceneName, const std::string& cut);
 
       //Event cache status
       std::future<src::Source::metadata>& NextEventStatus(); //Get status of next event processing
@@ -78,6 +91,10 @@ namespace evd
       src::Source::metadata CurrentEvent() const; //Get the current event
 
       virtual void Render(const int width, const int height, const ImGuiIO& ioState); //Render this window
+
+      //Would drawing a frame now change anything without new input?  True when an event was loaded or a cut changed 
+      //since the last Render(), when an event in the cache finished processing, and while printing.
+      bool NeedsFrame() const;
     
     private:
       //Encapsulate major setup steps
@@ -98,6 +115,39 @@ namespace evd
       void ReadGeo();
       void ReadEvent();
 
+      //Printing.  Print() asks for an image, StartPrint() draws it in tiles the size of the window and starts reading 
+      //each tile back, and FinishPrint() sends the image to fPrintWriter once every tile has arrived.
+      void StartPrint(const int width, const int height);
+      void FinishPrint();
+      void RenderPrintSettings(const int width, const int height);
+
+      //A part of a printed image drawn in one pass
+      struct Tile
+      {
+        int fX; //Position of bottom left corner in the printed image
+        int fY;
+        int fWidth;
+        int fHeight;
+        std::unique_ptr<mygl::PixelBuffer> fPixels; //Read back without waiting for the GPU
+      };
+
+      std::unique_ptr<ImageWriter> fPrintWriter; //Encodes and writes images on another thread.  Created at the first Print().
+      mygl::Framebuffer fPrintTarget; //Each Tile is drawn here
+      std::vector<Tile> fTiles; //Tiles of the image being printed.  Empty if no image is being printed.
+      bool fPrintRequested; //Did the user ask for an image that hasn't been started yet?
+      int fPrintWidth; //Size of the image being printed
+      int fPrintHeight;
+      std::string fPrintFile; //Name of the file being printed
+
+      //Print settings
+      bool fShowPrintSettings; //Draw the Print Settings window?
+      int fPrintFormat; //Position in the list of image formats
+      int fPrintScale; //Images are fPrintScale times as wide and as tall as the window
+      char fPrintName[256]; //File name without extension.  {file}, {run}, {event}, and {n} are replaced.
+      char fPrintDirectory[256]; //Where images are written
+      size_t fNPrinted; //Images printed this session for {n}
+      std::string fPrintStatus; //Result of the last Print() for the Print Settings window
+
       //Resources used by all plugins
       draw::Services fServices;
 
@@ -105,10 +155,20 @@ namespace evd
       std::vector<std::unique_ptr<draw::GeoControllerBase>> fGlobalDrawers; //Run for every file
       std::vector<std::unique_ptr<draw::EventControllerBase>> fEventDrawers; //Run for event event
       std::vector<std::unique_ptr<draw::CameraConfig>> fCameraConfigs; //Register camera(s) for every event
+      std::vector<std::string> fGlobalNames; //Name of each plugin in fGlobalDrawers for timing
+      std::vector<std::string> fEventNames; //Name of each plugin in fEventDrawers for timing
       //std::vector<std::unique_ptr<draw::ExternalDrawer>> fExtDrawers;
 
+      //Size of fEventCache and whether its first and last events are ready.  States react when this changes.
+      std::tuple<size_t, bool, bool> CacheStatus() const;
+
+      //Render on demand
+      bool fNeedsFrame; //Did something change that the last Render() didn't draw?
+      std::tuple<size_t, bool, bool> fDrawnCacheStatus; //CacheStatus() during the last Render()
+
       //Event processing status
       std::queue<std::future<src::Source::metadata>> fEventCache; //Events in processing and that are ready to be loaded
+      std::queue<std::shared_ptr<mygl::Profiler::EventRecord>> fEventRecords; //Timing of each event in fEventCache
       src::Source::metadata fCurrentEvent; //Source state when current event was first processed
   };
 }
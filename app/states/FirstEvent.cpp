@@ -18,7 +18,7 @@
 //OpenGL functions get provided through this include
 #include "glad/include/glad/glad.h"
 
-fsm::FirstEvent::FirstEvent(): State()
+fsm::FirstEvent::FirstEvent(): State(), fRequested(mygl::Profiler::clock::now())
 {
 }
 
@@ -26,7 +26,7 @@ std::unique_ptr<fsm::State> fsm::FirstEvent::doPoll(evd::Window& window)
 {
   if(window.NextEventStatus().wait_for(std::chrono::milliseconds(10)) == std::future_status::ready)
   {
-    window.LoadNextEvent();
+    window.LoadNextEvent(fRequested);
     return std::unique_ptr<State>(new Running());
   }
   return nullptr;
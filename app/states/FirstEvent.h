@@ -11,6 +11,9 @@
 //Local includes
 #include "State.h"
 
+//gl includes
+#include "gl/Profiler.h"
+
 namespace fsm
 {
   class FirstEvent: public State
@@ -22,6 +25,9 @@ namespace fsm
     protected:
       virtual std::unique_ptr<State> doPoll(evd::Window& window) override;
       virtual std::unique_ptr<State> Draw(const int width, const int height, const ImGuiIO& io, evd::Window& window) override;
+
+    private:
+      mygl::Profiler::clock::time_point fRequested; //When the user asked to see the next event
   };
 }
 
@@ -28,9 +28,12 @@ namespace fsm
     ImGui::Begin("Control Bar", nullptr, ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoScrollWithMouse);
     if(ImGui::Button("Print"))
     {
-      window.Print(width, height);
+      window.Print();
     } 
     ImGui::SameLine();
+    if(ImGui::Button("...")) window.ShowPrintSettings() = true;
+    if(ImGui::IsItemHovered()) ImGui::SetTooltip("Print Settings");
+    ImGui::SameLine();
 
     int ids[] = {window.CurrentEvent().runID, window.CurrentEvent().eventID};
     if(ImGui::InputInt2("(Run, Event)", ids, ImGuiInputTextFlags_EnterReturnsTrue)) transition = std::unique_ptr<State>(new Goto(ids[0], ids[1]));
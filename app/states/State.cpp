@@ -26,8 +26,11 @@ std::unique_ptr<fsm::State> fsm::State::Draw(const int width, const int height,
   ImGui::Begin("Control Bar", nullptr, ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoScrollWithMouse);
   if(ImGui::Button("Print")) //Print button always works
   {
-    window.Print(width, height);
+    window.Print();
   }
+  ImGui::SameLine();
+  if(ImGui::Button("...")) window.ShowPrintSettings() = true;
+  if(ImGui::IsItemHovered()) ImGui::SetTooltip("Print Settings");
   {
     detail::Disable disabled(ImGuiCol_Button, ImGuiCol_ButtonHovered, ImGuiCol_ButtonActive, ImGuiCol_Text);
     ImGui::SameLine();
@@ -17,7 +17,7 @@
 //OpenGL functions get provided through this include
 #include "glad/include/glad/glad.h"
 
-fsm::TryLoadNextEvent::TryLoadNextEvent()
+fsm::TryLoadNextEvent::TryLoadNextEvent(): fRequested(mygl::Profiler::clock::now())
 {
 }
 
@@ -39,7 +39,7 @@ std::unique_ptr<fsm::State> fsm::TryLoadNextEvent::doPoll(evd::Window& window)
   //If the next event is ready, load it into the window and go to the Running state
   try
   {
-    window.LoadNextEvent();
+    window.LoadNextEvent(fRequested);
   }
   catch(const src::Source::no_more_files& e)
   {
@@ -10,6 +10,9 @@
 //Local includes
 #include "State.h"
 
+//gl includes
+#include "gl/Profiler.h"
+
 namespace fsm
 {
   class TryLoadNextEvent: public State
@@ -20,6 +23,9 @@ namespace fsm
 
     protected:
       virtual std::unique_ptr<State> doPoll(evd::Window& window) override;
+
+    private:
+      mygl::Profiler::clock::time_point fRequested; //When the user asked to see the next event
   };
 }
 
@@ -0,0 +1,332 @@
+//File: EvdBench.cpp
+//Brief: Runs the drawing stage of every Global and Event plugin in a configuration file over the events in an edep-sim
+//       file without a window or an OpenGL context.  Reports wall time, allocations, peak resident memory, and how many
+//       TreeNodes and vertices each plugin made as JSON so that runs can be compared to look for regressions.  Plugins
+//       run one after another in configuration order like they do in the application, so the first plugin that builds
+//       a per-event index in Services, like EventView, pays for it.
+//       Pass "synthetic" instead of a file to draw events from the configuration's Synthetic block that are made in
+//       memory by a synth::EventGenerator.  That leaves reading files out of the measurement.
+//       Usage: EvdBench <config.yaml> <edepsim.root or synthetic> [nEvents] [output.json]
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//plugin includes
+#include "plugins/Factory.cpp"
+#include "plugins/drawing/geometry/GeoController.cpp"
+#include "plugins/drawing/event/EventController.cpp"
+#include "plugins/drawing/Services.cpp"
+#include "plugins/drawing/ForceDependencyOnLibraries.h"
+
+//app includes
+#include "app/Source.h"
+
+//bench includes
+#include "bench/Synthetic.h"
+
+//yaml-cpp includes
+#include "yaml-cpp/yaml.h"
+
+//edepsim includes
+#include "TG4Event.h"
+
+//POSIX includes
+#include <sys/resource.h>
+
+//c++ includes
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <limits>
+#include <vector>
+#include <string>
+
+namespace
+{
+  //Every allocation made through operator new by any thread since the program started
+  std::atomic<size_t> gAllocations(0);
+  std::atomic<size_t> gAllocatedBytes(0);
+}
+
+//Count allocations in plugin libraries too.  Replacing operator new in the executable replaces it for the whole process.
+void* operator new(std::size_t size)
+{
+  gAllocations.fetch_add(1, std::memory_order_relaxed);
+  gAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+  if(void* ptr = std::malloc(size?size:1)) return ptr;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+  return ::operator new(size);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace
+{
+  //Allocations since this AllocCounter was created
+  class AllocCounter
+  {
+    public:
+      AllocCounter(): fAllocations(gAllocations.load()), fBytes(gAllocatedBytes.load()) {}
+
+      size_t Allocations() const { return gAllocations.load() - fAllocations; }
+      size_t Bytes() const { return gAllocatedBytes.load() - fBytes; }
+
+    private:
+      const size_t fAllocations;
+      const size_t fBytes;
+  };
+
+  //Largest resident set size this process has had so far in kilobytes
+  long PeakRSSKB()
+  {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; //kilobytes on Linux
+  }
+
+  //Everything measured about one plugin over a whole job
+  struct PluginStats
+  {
+    PluginStats(const std::string& name, const std::string& stage): fName(name), fStage(stage), fCalls(0), fSeconds(0),
+                                                                    fMaxSeconds(0), fAllocations(0), fBytes(0), fRSSGrowthKB(0),
+                                                                    fNodes(0), fVertices(0), fIndices(0)
+    {
+    }
+
+    std::string fName; //Name of this plugin in the configuration file
+    std::string fStage; //Global or Event
+    size_t fCalls; //Number of times this plugin drew something
+    double fSeconds; //Total wall time spent drawing
+    double fMaxSeconds; //Slowest single call
+    size_t fAllocations; //Number of calls to operator new while drawing
+    size_t fBytes; //Bytes requested from operator new while drawing
+    long fRSSGrowthKB; //How much the process' peak resident set size grew while drawing
+    size_t fNodes; //TreeNodes in all SceneModels made
+    size_t fVertices; //Vertices in all SceneModels made
+    size_t fIndices; //Vertex indices in all SceneModels made
+  };
+
+  //A plugin loaded from the configuration file along with what has been measured about it
+  template <class BASE>
+  struct Plugin
+  {
+    std::unique_ptr<BASE> fPlugin;
+    PluginStats fStats;
+  };
+
+  //Same as loadPlugins() in Window.cpp, but keep each plugin's name
+  template <class BASE>
+  std::vector<Plugin<BASE>> LoadPlugins(const YAML::Node& pluginConfig, const std::string& stage)
+  {
+    auto& factory = plgn::Factory<BASE>::instance();
+    std::vector<Plugin<BASE>> plugins;
+    if(!pluginConfig[stage]) return plugins;
+
+    const auto& config = pluginConfig[stage];
+    for(auto plugin = config.begin(); plugin != config.end(); ++plugin)
+    {
+      const auto name = plugin->first.as<std::string>();
+      auto drawer = factory.Get(name, plugin->second);
+      if(drawer != nullptr) plugins.push_back(Plugin<BASE>{std::move(drawer), PluginStats(name, stage)});
+      else std::cerr << "Failed to get " << stage << " plugin named " << name << "\n";
+    }
+
+    return plugins;
+  }
+
+  //Draw args with plugin and record what it cost.  The SceneModel is destroyed after it is measured,
+  //so freeing it is not part of the time reported.
+  template <class BASE, class ...ARGS>
+  void Run(Plugin<BASE>& plugin, ARGS&... args)
+  {
+    auto& stats = plugin.fStats;
+    const auto rssBefore = PeakRSSKB();
+    const AllocCounter allocs;
+    const auto start = std::chrono::steady_clock::now();
+    const auto model = plugin.fPlugin->DrawModel(args...);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    ++stats.fCalls;
+    stats.fSeconds += seconds;
+    stats.fMaxSeconds = std::max(stats.fMaxSeconds, seconds);
+    stats.fAllocations += allocs.Allocations();
+    stats.fBytes += allocs.Bytes();
+    stats.fRSSGrowthKB += PeakRSSKB() - rssBefore;
+
+    if(model)
+    {
+      stats.fVertices += model->VAOModel().Vertices().size();
+      stats.fIndices += model->VAOModel().Indices().size();
+      for(const auto& top: model->TopLevelNodes()) top.walk([&stats](const auto& /*node*/) { ++stats.fNodes; });
+    }
+  }
+
+  //Quote str as a JSON string
+  std::string JSONString(const std::string& str)
+  {
+    std::stringstream quoted;
+    quoted << "\"";
+    for(const char c: str)
+    {
+      if(c == '"' || c == '\\') quoted << "\\" << c;
+      else if(static_cast<unsigned char>(c) < 0x20) quoted << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec;
+      else quoted << c;
+    }
+    quoted << "\"";
+    return quoted.str();
+  }
+
+  void WriteJSON(std::ostream& out, const PluginStats& stats, const size_t nEvents)
+  {
+    out << "    {\n"
+        << "      \"name\": " << JSONString(stats.fName) << ",\n"
+        << "      \"stage\": " << JSONString(stats.fStage) << ",\n"
+        << "      \"calls\": " << stats.fCalls << ",\n"
+        << "      \"wallSeconds\": " << stats.fSeconds << ",\n"
+        << "      \"meanSeconds\": " << ((stats.fCalls > 0)?stats.fSeconds/stats.fCalls:0.) << ",\n"
+        << "      \"maxSeconds\": " << stats.fMaxSeconds << ",\n"
+        << "      \"eventsPerSecond\": " << ((stats.fStage == "Event" && stats.fSeconds > 0)?nEvents/stats.fSeconds:0.) << ",\n"
+        << "      \"allocations\": " << stats.fAllocations << ",\n"
+        << "      \"allocatedBytes\": " << stats.fBytes << ",\n"
+        << "      \"peakRSSGrowthKB\": " << stats.fRSSGrowthKB << ",\n"
+        << "      \"nodes\": " << stats.fNodes << ",\n"
+        << "      \"vertices\": " << stats.fVertices << ",\n"
+        << "      \"indices\": " << stats.fIndices << "\n"
+        << "    }";
+  }
+}
+
+int main(const int argc, const char** argv)
+{
+  if(argc < 3)
+  {
+    std::cerr << "Usage: EvdBench <config.yaml> <edepsim.root or synthetic> [nEvents] [output.json]\n";
+    return 1;
+  }
+
+  const std::string configName = argv[1], fileName = argv[2];
+  size_t maxEvents = std::numeric_limits<size_t>::max();
+  if(argc > 3) maxEvents = std::stoul(argv[3]);
+  const std::string outName = (argc > 4)?argv[4]:"EvdBench.json";
+
+  const auto config = YAML::LoadFile(configName);
+  const auto& drawers = config["Drawers"];
+  auto geoPlugins = LoadPlugins<draw::GeoControllerBase>(drawers, "Global");
+  auto eventPlugins = LoadPlugins<draw::EventControllerBase>(drawers, "Event");
+
+  YAML::Node geoConfig;
+  if(config["Services"] && config["Services"]["Geo"]) geoConfig = config["Services"]["Geo"];
+  else std::cerr << "Couldn't find Geo service.  Using the default util::Geometry configuration.\n";
+
+  //Events come from either a file or a synth::EventGenerator
+  std::unique_ptr<src::Source> source;
+  std::unique_ptr<synth::EventGenerator> generator;
+  TG4Event synthEvent;
+  if(fileName == "synthetic")
+  {
+    YAML::Node synthConfig;
+    if(config["Synthetic"]) synthConfig = config["Synthetic"];
+    generator.reset(new synth::EventGenerator(synthConfig));
+    if(argc <= 3) maxEvents = 100;
+  }
+  else source.reset(new src::Source(fileName));
+
+  draw::Services services;
+
+  size_t nEvents = 0;
+  double readSeconds = 0; //Time spent in Source instead of plugins
+  const auto start = std::chrono::steady_clock::now();
+  while(nEvents < maxEvents)
+  {
+    const auto readStart = std::chrono::steady_clock::now();
+    bool newFile = (nEvents == 0);
+    if(generator) generator->Fill(synthEvent, nEvents);
+    else
+    {
+      try
+      {
+        newFile = source->Next().newFile || newFile;
+      }
+      catch(const src::Source::no_more_files& /*e*/)
+      {
+        break;
+      }
+    }
+    auto geo = generator?generator->Geometry():source->Geo();
+
+    if(newFile)
+    {
+      services.fGeometry.reset(new util::Geometry(geoConfig, geo));
+      readSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - readStart).count();
+      for(auto& plugin: geoPlugins) Run(plugin, *geo, services);
+    }
+    else readSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - readStart).count();
+
+    //These belong to the last event
+    services.fEventView.reset();
+    services.fTopology.reset();
+
+    const auto& evt = generator?synthEvent:source->Event();
+    for(auto& plugin: eventPlugins) Run(plugin, evt, services);
+    ++nEvents;
+  }
+  const double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  double eventSeconds = 0;
+  for(const auto& plugin: eventPlugins) eventSeconds += plugin.fStats.fSeconds;
+
+  //Machine-readable report
+  std::ofstream out(outName);
+  out << std::setprecision(9);
+  out << "{\n"
+      << "  \"config\": " << JSONString(configName) << ",\n"
+      << "  \"input\": " << JSONString(fileName) << ",\n"
+      << "  \"events\": " << nEvents << ",\n"
+      << "  \"wallSeconds\": " << wallSeconds << ",\n"
+      << "  \"readSeconds\": " << readSeconds << ",\n"
+      << "  \"eventDrawSeconds\": " << eventSeconds << ",\n"
+      << "  \"eventsPerSecond\": " << ((wallSeconds > 0)?nEvents/wallSeconds:0.) << ",\n"
+      << "  \"peakRSSKB\": " << PeakRSSKB() << ",\n"
+      << "  \"plugins\": [\n";
+  bool first = true;
+  for(const auto& plugin: geoPlugins)
+  {
+    if(!first) out << ",\n";
+    WriteJSON(out, plugin.fStats, nEvents);
+    first = false;
+  }
+  for(const auto& plugin: eventPlugins)
+  {
+    if(!first) out << ",\n";
+    WriteJSON(out, plugin.fStats, nEvents);
+    first = false;
+  }
+  out << "\n  ]\n}\n";
+
+  //Summary for humans
+  std::cout << std::setw(20) << "plugin" << std::setw(8) << "stage" << std::setw(14) << "ms/call" << std::setw(14) << "allocs/call"
+            << std::setw(14) << "nodes/call" << std::setw(16) << "vertices/call" << "\n";
+  const auto summarize = [](const PluginStats& stats)
+                         {
+                           const double calls = std::max<size_t>(stats.fCalls, 1);
+                           std::cout << std::setw(20) << stats.fName << std::setw(8) << stats.fStage
+                                     << std::setw(14) << 1000.*stats.fSeconds/calls << std::setw(14) << stats.fAllocations/calls
+                                     << std::setw(14) << stats.fNodes/calls << std::setw(16) << stats.fVertices/calls << "\n";
+                         };
+  for(const auto& plugin: geoPlugins) summarize(plugin.fStats);
+  for(const auto& plugin: eventPlugins) summarize(plugin.fStats);
+  std::cout << nEvents << " events at " << ((wallSeconds > 0)?nEvents/wallSeconds:0.) << " events/s with a peak RSS of "
+            << PeakRSSKB() << " kB.  Wrote " << outName << "\n";
+
+  return 0;
+}
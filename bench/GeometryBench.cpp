@@ -0,0 +1,125 @@
+//File: GeometryBench.cpp
+//Brief: Times util::Geometry::FindMaterial() against TGeoManager::FindNode() on a small detector-like geometry 
+//       and reports how often the voxel grid disagrees with the navigator.  Points are thrown uniformly in the 
+//       fiducial volume's bounding box.  The first pass over the points pays for classifying voxels, and the second 
+//       pass shows the steady state that plugins see when drawing later events.  
+//       Usage: GeometryBench [nPoints] [voxelSize in mm]
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//util includes
+#include "util/Geometry.cpp"
+
+//yaml-cpp includes
+#include "yaml-cpp/yaml.h"
+
+//ROOT includes
+#include "TGeoManager.h"
+#include "TGeoBBox.h"
+#include "TGeoTube.h"
+#include "TGeoMatrix.h"
+#include "TGeoMaterial.h"
+#include "TGeoMedium.h"
+#include "TVector3.h"
+
+//c++ includes
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+
+namespace
+{
+  //Builds a world of air around a steel cryostat full of argon.  The argon has a stack of thin scintillator 
+  //planes and a tube of lead in it so that some voxels have more than one material.
+  TGeoManager* MakeGeometry()
+  {
+    auto man = new TGeoManager("GeometryBench", "Geometry for util::Geometry benchmark");
+
+    auto air = new TGeoMedium("Air", 1, new TGeoMaterial("Air", 14.6, 7.3, 0.0012));
+    auto steel = new TGeoMedium("Steel", 2, new TGeoMaterial("Steel", 55.8, 26., 7.9));
+    auto argon = new TGeoMedium("LAr", 3, new TGeoMaterial("LAr", 39.9, 18., 1.4));
+    auto scint = new TGeoMedium("Scint", 4, new TGeoMaterial("Scint", 12.0, 6., 1.03));
+    auto lead = new TGeoMedium("Lead", 5, new TGeoMaterial("Lead", 207.2, 82., 11.35));
+
+    auto world = man->MakeBox("volWorld", air, 5000., 5000., 5000.);
+    man->SetTopVolume(world);
+
+    auto cryostat = man->MakeBox("volCryostat", steel, 2100., 2100., 3100.);
+    world->AddNode(cryostat, 1, new TGeoTranslation(0., 0., 500.));
+
+    auto lar = man->MakeBox("volLAr", argon, 2000., 2000., 3000.);
+    cryostat->AddNode(lar, 1);
+
+    auto plane = man->MakeBox("volPlane", scint, 1900., 1900., 5.);
+    for(int layer = 0; layer < 20; ++layer) lar->AddNode(plane, layer, new TGeoTranslation(0., 0., -2850. + 300.*layer));
+
+    auto rod = man->MakeTube("volRod", lead, 0., 150., 1000.);
+    lar->AddNode(rod, 1, new TGeoTranslation(500., -300., 100.));
+
+    man->CloseGeometry();
+    return man;
+  }
+
+  template <class FUNC>
+  double SecondsFor(FUNC&& func)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+}
+
+int main(const int argc, const char** argv)
+{
+  size_t nPoints = 1000000;
+  if(argc > 1) nPoints = std::stoul(argv[1]);
+
+  auto man = MakeGeometry();
+
+  YAML::Node config;
+  config["fiducial"] = "volCryostat";
+  if(argc > 2) config["voxelSize"] = std::stod(argv[2]);
+  util::Geometry geo(config, man);
+
+  //Throw points in the cryostat's bounding box
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> xy(-2100., 2100.), z(-2600., 3600.);
+  std::vector<TVector3> points;
+  points.reserve(nPoints);
+  for(size_t point = 0; point < nPoints; ++point) points.emplace_back(xy(gen), xy(gen), z(gen));
+
+  std::vector<const TGeoMaterial*> exact(nPoints), cold(nPoints), warm(nPoints);
+  const double navTime = SecondsFor([&]
+                                    {
+                                      for(size_t point = 0; point < nPoints; ++point) 
+                                      {
+                                        const auto& pos = points[point];
+                                        exact[point] = man->FindNode(pos.X(), pos.Y(), pos.Z())->GetVolume()->GetMaterial();
+                                      }
+                                    });
+  const double coldTime = SecondsFor([&]
+                                     { 
+                                       for(size_t point = 0; point < nPoints; ++point) cold[point] = &geo.FindMaterial(points[point]); 
+                                     });
+  const double warmTime = SecondsFor([&]
+                                     { 
+                                       for(size_t point = 0; point < nPoints; ++point) warm[point] = &geo.FindMaterial(points[point]); 
+                                     });
+
+  size_t coldWrong = 0, warmWrong = 0;
+  for(size_t point = 0; point < nPoints; ++point)
+  {
+    if(cold[point] != exact[point]) ++coldWrong;
+    if(warm[point] != exact[point]) ++warmWrong;
+  }
+
+  std::cout << std::setw(20) << "method" << std::setw(18) << "lookups/s" << std::setw(14) << "mismatches" << "\n"
+            << std::setw(20) << "FindNode" << std::setw(18) << nPoints/navTime << std::setw(14) << 0 << "\n"
+            << std::setw(20) << "FindMaterial cold" << std::setw(18) << nPoints/coldTime << std::setw(14) << coldWrong << "\n"
+            << std::setw(20) << "FindMaterial warm" << std::setw(18) << nPoints/warmTime << std::setw(14) << warmWrong << "\n";
+  std::cout << "Accuracy: " << 100.*(nPoints - warmWrong)/nPoints << "% of " << nPoints << " points agree with the navigator.\n";
+
+  return 0;
+}
@@ -0,0 +1,38 @@
+//File: MakeSyntheticEvents.cpp
+//Brief: Writes synthetic edep-sim events from the Synthetic block of a YAML file to a ROOT file that the event display
+//       and EvdBench can read like any other edep-sim file.  See Synthetic.h for the configuration.
+//       Usage: MakeSyntheticEvents <config.yaml> <output.root> [nEvents]
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//bench includes
+#include "bench/Synthetic.h"
+
+//yaml-cpp includes
+#include "yaml-cpp/yaml.h"
+
+//c++ includes
+#include <iostream>
+#include <string>
+
+int main(const int argc, const char** argv)
+{
+  if(argc < 3)
+  {
+    std::cerr << "Usage: MakeSyntheticEvents <config.yaml> <output.root> [nEvents]\n";
+    return 1;
+  }
+
+  size_t nEvents = 100;
+  if(argc > 3) nEvents = std::stoul(argv[3]);
+
+  const auto config = YAML::LoadFile(argv[1]);
+  YAML::Node synthConfig;
+  if(config["Synthetic"]) synthConfig = config["Synthetic"];
+  else std::cerr << "Couldn't find a Synthetic block in " << argv[1] << ".  Using the default configuration.\n";
+
+  synth::EventGenerator gen(synthConfig);
+  gen.Write(argv[2], nEvents);
+  std::cout << "Wrote " << nEvents << " events with " << gen.NTrajectories() << " trajectories each to " << argv[2] << "\n";
+
+  return 0;
+}
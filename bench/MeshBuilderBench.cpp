@@ -0,0 +1,67 @@
+//File: MeshBuilderBench.cpp
+//Brief: Times mygl::MeshBuilder on common ROOT shapes.  Each shape is tesselated by ROOT and turned into 
+//       GL_TRIANGLE_STRIP_ADJACENCY indices many times, and the average time per shape is printed.  
+//       Usage: MeshBuilderBench [nRepetitions]
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//gl includes
+#include "gl/model/MeshBuilder.h"
+
+//ROOT includes
+#include "TGeoManager.h"
+#include "TGeoBBox.h"
+#include "TGeoTube.h"
+#include "TGeoPcon.h"
+#include "TGeoMatrix.h"
+#include "TGeoCompositeShape.h"
+
+//c++ includes
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <utility>
+
+int main(const int argc, const char** argv)
+{
+  size_t nReps = 10000;
+  if(argc > 1) nReps = std::stoul(argv[1]);
+
+  //TGeoCompositeShape looks up its components by name in gGeoManager
+  new TGeoManager("MeshBuilderBench", "Shapes for MeshBuilder benchmark");
+
+  auto box = new TGeoBBox("benchBox", 100., 50., 25.);
+  auto tube = new TGeoTube("benchTube", 10., 40., 200.);
+
+  auto pcon = new TGeoPcon("benchPcon", 0., 360., 4);
+  pcon->DefineSection(0, -100., 0., 20.);
+  pcon->DefineSection(1, -20., 0., 50.);
+  pcon->DefineSection(2, 20., 10., 50.);
+  pcon->DefineSection(3, 100., 10., 30.);
+
+  auto shift = new TGeoTranslation("benchShift", 50., 0., 0.);
+  shift->RegisterYourself();
+  auto composite = new TGeoCompositeShape("benchComposite", "benchBox-benchTube:benchShift");
+
+  const std::vector<std::pair<std::string, TGeoShape*>> shapes = {{"box", box}, {"tube", tube}, {"polycone", pcon}, 
+                                                                 {"composite", composite}};
+
+  mygl::MeshBuilder builder;
+  std::cout << std::setw(12) << "shape" << std::setw(10) << "points" << std::setw(10) << "polygons" << std::setw(10) << "indices" 
+            << std::setw(16) << "us per build" << "\n";
+  for(const auto& shape: shapes)
+  {
+    builder.Build(shape.second); //Warm up ROOT's static buffers and MeshBuilder's scratch space
+
+    const auto start = std::chrono::steady_clock::now();
+    for(size_t rep = 0; rep < nReps; ++rep) builder.Build(shape.second);
+    const auto end = std::chrono::steady_clock::now();
+
+    const double usPerBuild = std::chrono::duration<double, std::micro>(end - start).count()/nReps;
+    std::cout << std::setw(12) << shape.first << std::setw(10) << builder.Points().size() << std::setw(10) 
+              << builder.PolygonSizes().size() << std::setw(10) << builder.Indices().size() << std::setw(16) << usPerBuild << "\n";
+  }
+
+  return 0;
+}
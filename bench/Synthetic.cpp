@@ -0,0 +1,331 @@
+//File: Synthetic.cpp
+//Brief: Fabricates edep-sim events and a matching geometry for performance tests.  See Synthetic.h for configuration.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//bench includes
+#include "bench/Synthetic.h"
+
+//util includes
+#include "util/GenException.h"
+
+//ROOT includes
+#include "TGeoManager.h"
+#include "TGeoMaterial.h"
+#include "TGeoMedium.h"
+#include "TGeoMatrix.h"
+#include "TLorentzVector.h"
+#include "TVector3.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TClass.h"
+#include "TDataMember.h"
+
+//edepsim includes
+#include "TG4Event.h"
+
+//c++ includes
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+  #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
+  //edep-sim only lets its' PersistencyManager write fields when EDEPSIM_FORCE_PRIVATE_FIELDS is set, but ROOT's
+  //dictionary still knows where each one is.  offset caches where name is for each place EDEP_FIELD() is used.
+  template <class T, class CLASS>
+  T& Member(CLASS& object, const char* name, Long_t& offset)
+  {
+    if(offset == 0)
+    {
+      auto member = CLASS::Class()->GetDataMember(name);
+      if(member == nullptr || member->GetUnitSize() != sizeof(T))
+      {
+        throw util::GenException("Synthetic Event") << CLASS::Class()->GetName() << " doesn't have a " << sizeof(T)
+                                                    << "-byte member named " << name << ".\n";
+      }
+      offset = member->GetOffset();
+    }
+    return *reinterpret_cast<T*>(reinterpret_cast<char*>(&object) + offset);
+  }
+
+  #define EDEP_FIELD(object, type, member) Member<type>(object, #member, []() -> Long_t& { static Long_t offset = 0; return offset; }())
+  #else
+  #define EDEP_FIELD(object, type, member) (object).member
+  #endif
+
+  //Particles that synthetic trajectories can be
+  struct Particle
+  {
+    int fPDG;
+    const char* fName;
+    double fMass; //MeV
+  };
+
+  const std::vector<Particle> primaryTypes = {{13, "mu-", 105.66}, {-13, "mu+", 105.66}, {211, "pi+", 139.57}, {-211, "pi-", 139.57},
+                                              {2212, "proton", 938.27}, {11, "e-", 0.511}, {321, "K+", 493.68}, {2112, "neutron", 939.57}};
+  const std::vector<Particle> secondaryTypes = {{11, "e-", 0.511}, {22, "gamma", 0.}, {2112, "neutron", 939.57},
+                                                {2212, "proton", 938.27}, {211, "pi+", 139.57}};
+
+  //Reactions in the format GENIE writes them
+  const std::vector<std::string> reactions = {"nu:14;tgt:1000180400;N:2112;proc:Weak[CC],QES;",
+                                              "nu:14;tgt:1000180400;N:2212;proc:Weak[CC],RES;",
+                                              "nu:-14;tgt:1000180400;N:2212;proc:Weak[NC],DIS;"};
+
+  constexpr double c = 299.792458; //mm/ns
+
+  //Where Particle with pdg is in types
+  const Particle& Find(const std::vector<Particle>& types, const int pdg)
+  {
+    return *std::find_if(types.begin(), types.end(), [pdg](const Particle& type) { return type.fPDG == pdg; });
+  }
+}
+
+namespace synth
+{
+  EventGenerator::EventGenerator(const YAML::Node& config): fSeed(42), fRun(0), fVertices(1), fPrimaries(4), fPoints(20),
+                                                            fShowerDepth(2), fChildren(2), fSegments(10), fDetectors(1),
+                                                            fStepLength(10.), fHalfSize{1000., 1000., 1000.}, fGeo(), fDetectorNames()
+  {
+    if(config["Seed"]) fSeed = config["Seed"].as<unsigned int>();
+    if(config["Run"]) fRun = config["Run"].as<int>();
+    if(config["Vertices"]) fVertices = config["Vertices"].as<size_t>();
+    if(config["Primaries"]) fPrimaries = config["Primaries"].as<size_t>();
+    if(config["PointsPerTrajectory"]) fPoints = config["PointsPerTrajectory"].as<size_t>();
+    if(config["ShowerDepth"]) fShowerDepth = config["ShowerDepth"].as<size_t>();
+    if(config["Children"]) fChildren = config["Children"].as<size_t>();
+    if(config["SegmentsPerTrajectory"]) fSegments = config["SegmentsPerTrajectory"].as<size_t>();
+    if(config["Detectors"]) fDetectors = config["Detectors"].as<size_t>();
+    if(config["StepLength"]) fStepLength = config["StepLength"].as<double>();
+    if(config["DetectorSize"])
+    {
+      const auto size = config["DetectorSize"].as<std::vector<double>>();
+      if(size.size() != 3) throw util::GenException("Synthetic Configuration") << "DetectorSize must have 3 half-lengths, but it has "
+                                                                             << size.size() << ".\n";
+      std::copy(size.begin(), size.end(), fHalfSize);
+    }
+
+    if(fPoints < 2) throw util::GenException("Synthetic Configuration") << "PointsPerTrajectory must be at least 2.\n";
+    if(fDetectors < 1) throw util::GenException("Synthetic Configuration") << "Detectors must be at least 1.\n";
+    if(fStepLength <= 0.) throw util::GenException("Synthetic Configuration") << "StepLength must be positive.\n";
+
+    MakeGeometry();
+  }
+
+  EventGenerator::~EventGenerator() {}
+
+  size_t EventGenerator::NTrajectories() const
+  {
+    size_t perPrimary = 0, generation = 1;
+    for(size_t depth = 0; depth <= fShowerDepth; ++depth)
+    {
+      perPrimary += generation;
+      generation *= fChildren;
+    }
+    return fVertices*fPrimaries*perPrimary;
+  }
+
+  //A world of air around a box of argon.  With more than one Detector, the argon is split into slabs in z that are
+  //each their own SegmentDetector.
+  void EventGenerator::MakeGeometry()
+  {
+    fGeo.reset(new TGeoManager("Synthetic", "Geometry for synthetic edep-sim events"));
+
+    auto air = new TGeoMedium("Air", 1, new TGeoMaterial("Air", 14.6, 7.3, 0.0012));
+    auto argon = new TGeoMedium("LAr", 2, new TGeoMaterial("LAr", 39.9, 18., 1.4));
+
+    auto world = fGeo->MakeBox("volWorld", air, 2.*fHalfSize[0], 2.*fHalfSize[1], 2.*fHalfSize[2]);
+    fGeo->SetTopVolume(world);
+
+    auto detector = fGeo->MakeBox("volDetector", argon, fHalfSize[0], fHalfSize[1], fHalfSize[2]);
+    world->AddNode(detector, 1);
+
+    if(fDetectors == 1) fDetectorNames.push_back("volDetector");
+    else
+    {
+      const double slabHalf = fHalfSize[2]/fDetectors;
+      for(size_t slab = 0; slab < fDetectors; ++slab)
+      {
+        fDetectorNames.push_back("volDetector_"+std::to_string(slab));
+        auto volume = fGeo->MakeBox(fDetectorNames.back().c_str(), argon, fHalfSize[0], fHalfSize[1], slabHalf);
+        detector->AddNode(volume, 1, new TGeoTranslation(0., 0., -fHalfSize[2] + (2*slab+1)*slabHalf));
+      }
+    }
+
+    fGeo->CloseGeometry();
+  }
+
+  void EventGenerator::Fill(TG4Event& evt, const int eventID) const
+  {
+    evt.RunId = fRun;
+    evt.EventId = eventID;
+    evt.Primaries.clear();
+    evt.Trajectories.clear();
+    evt.SegmentDetectors.clear();
+
+    //Trajectories are referred to while their children are added
+    evt.Trajectories.reserve(NTrajectories());
+    for(const auto& name: fDetectorNames) evt.SegmentDetectors[name];
+
+    std::seed_seq seed{fSeed, static_cast<unsigned int>(eventID)};
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> unit(0., 1.);
+
+    //Primaries
+    for(size_t vert = 0; vert < fVertices; ++vert)
+    {
+      const double pos[] = {0.8*fHalfSize[0]*(2.*unit(gen)-1.), 0.8*fHalfSize[1]*(2.*unit(gen)-1.), 0.8*fHalfSize[2]*(2.*unit(gen)-1.)};
+
+      TG4PrimaryVertex vertex;
+      EDEP_FIELD(vertex, TLorentzVector, Position) = TLorentzVector(pos[0], pos[1], pos[2], 0.);
+      EDEP_FIELD(vertex, std::string, GeneratorName) = "synthetic";
+      EDEP_FIELD(vertex, std::string, Reaction) = reactions[(eventID + vert) % reactions.size()];
+
+      for(size_t prim = 0; prim < fPrimaries; ++prim)
+      {
+        const auto& type = primaryTypes[gen() % primaryTypes.size()];
+        auto& traj = AddTrajectory(evt, -1, type.fPDG, 100. + 1900.*unit(gen), pos, 0., gen);
+
+        TG4PrimaryParticle particle;
+        EDEP_FIELD(particle, int, TrackId) = EDEP_FIELD(traj, int, TrackId);
+        EDEP_FIELD(particle, int, PDGCode) = type.fPDG;
+        EDEP_FIELD(particle, std::string, Name) = type.fName;
+        EDEP_FIELD(particle, TLorentzVector, Momentum) = EDEP_FIELD(traj, TLorentzVector, InitialMomentum);
+        vertex.Particles.push_back(particle);
+      }
+
+      evt.Primaries.push_back(vertex);
+    }
+
+    //Showers.  Each generation's children start somewhere along the previous generation's trajectories.
+    size_t begin = 0, end = evt.Trajectories.size();
+    for(size_t depth = 0; depth < fShowerDepth; ++depth)
+    {
+      for(size_t parentPos = begin; parentPos < end; ++parentPos)
+      {
+        for(size_t child = 0; child < fChildren; ++child)
+        {
+          auto& parent = evt.Trajectories[parentPos];
+          const size_t whichPoint = 1 + gen() % (fPoints - 1);
+          const auto where = EDEP_FIELD(parent.Points[whichPoint], TLorentzVector, Position);
+          const double start[] = {where.X(), where.Y(), where.Z()};
+          const double parentEnergy = EDEP_FIELD(parent, TLorentzVector, InitialMomentum).E();
+          const int parentID = EDEP_FIELD(parent, int, TrackId);
+
+          const auto& type = secondaryTypes[gen() % secondaryTypes.size()];
+          const double energy = 1. + parentEnergy*(1. - double(whichPoint)/fPoints)*(0.1 + 0.4*unit(gen));
+          AddTrajectory(evt, parentID, type.fPDG, energy, start, where.T(), gen);
+        }
+      }
+      begin = end;
+      end = evt.Trajectories.size();
+    }
+
+    //Energy deposits
+    for(auto& traj: evt.Trajectories) AddSegments(evt, traj, gen);
+  }
+
+  //Trajectories are straight lines with a little bit of scattering at each point.  Kinetic energy decreases linearly
+  //to 0 at the last point.
+  TG4Trajectory& EventGenerator::AddTrajectory(TG4Event& evt, const int parentID, const int pdg, const double energy,
+                                               const double* start, const double time, std::mt19937& gen) const
+  {
+    evt.Trajectories.emplace_back();
+    auto& traj = evt.Trajectories.back();
+    const auto& type = Find((parentID < 0)?primaryTypes:secondaryTypes, pdg);
+
+    EDEP_FIELD(traj, int, TrackId) = evt.Trajectories.size() - 1;
+    EDEP_FIELD(traj, int, ParentId) = parentID;
+    EDEP_FIELD(traj, int, PDGCode) = pdg;
+    EDEP_FIELD(traj, std::string, Name) = type.fName;
+
+    std::uniform_real_distribution<double> unit(0., 1.);
+    std::normal_distribution<double> scatter(0., 0.05);
+    const double cosTheta = 2.*unit(gen) - 1., phi = 2.*M_PI*unit(gen), sinTheta = std::sqrt(1. - cosTheta*cosTheta);
+    TVector3 dir(sinTheta*std::cos(phi), sinTheta*std::sin(phi), cosTheta);
+    TVector3 pos(start[0], start[1], start[2]);
+    double t = time;
+
+    const auto momentum = [&type](const double kinetic) { return std::sqrt(kinetic*(kinetic + 2.*type.fMass)); };
+    EDEP_FIELD(traj, TLorentzVector, InitialMomentum) = TLorentzVector(momentum(energy)*dir, energy + type.fMass);
+
+    traj.Points.reserve(fPoints);
+    for(size_t point = 0; point < fPoints; ++point)
+    {
+      const double kinetic = energy*(1. - double(point)/(fPoints-1));
+      const double p = momentum(kinetic);
+
+      TG4TrajectoryPoint pt;
+      EDEP_FIELD(pt, TLorentzVector, Position) = TLorentzVector(pos, t);
+      EDEP_FIELD(pt, TVector3, Momentum) = p*dir;
+      EDEP_FIELD(pt, int, Process) = (point == fPoints-1)?1:2; //Transportation at the end, Electromagnetic otherwise
+      EDEP_FIELD(pt, int, Subprocess) = (point == fPoints-1)?91:2; //Ionization
+      traj.Points.push_back(pt);
+
+      const double beta = (kinetic > 0.)?p/(kinetic + type.fMass):1.;
+      pos += fStepLength*dir;
+      t += fStepLength/(std::max(beta, 0.01)*c);
+      dir = (dir + TVector3(scatter(gen), scatter(gen), scatter(gen))).Unit();
+    }
+
+    return traj;
+  }
+
+  //Segments divide a trajectory into equal lengths.  Each one is in the SegmentDetector whose slab its' start is in.
+  void EventGenerator::AddSegments(TG4Event& evt, TG4Trajectory& traj, std::mt19937& gen) const
+  {
+    std::uniform_real_distribution<double> dEdx(0.15, 0.35); //MeV/mm
+    const int trackID = EDEP_FIELD(traj, int, TrackId);
+    const double length = fStepLength*(fPoints-1)/fSegments;
+
+    //Position distance along traj from its' first point
+    const auto at = [this, &traj](const double distance)
+                    {
+                      const double steps = std::min(distance/fStepLength, double(fPoints-1));
+                      const size_t point = std::min(size_t(steps), fPoints-2);
+                      const double frac = steps - point;
+                      const auto& first = EDEP_FIELD(traj.Points[point], TLorentzVector, Position);
+                      const auto& second = EDEP_FIELD(traj.Points[point+1], TLorentzVector, Position);
+                      return first + frac*(second - first);
+                    };
+
+    for(size_t segment = 0; segment < fSegments; ++segment)
+    {
+      const auto start = at(segment*length), stop = at((segment+1)*length);
+      const double slabZ = (start.Z() + fHalfSize[2])/(2.*fHalfSize[2]);
+      const size_t detector = std::min(size_t(std::max(slabZ, 0.)*fDetectors), fDetectors-1);
+
+      TG4HitSegment seg;
+      EDEP_FIELD(seg, std::vector<int>, Contrib) = std::vector<int>{trackID};
+      EDEP_FIELD(seg, int, PrimaryId) = trackID;
+      EDEP_FIELD(seg, float, EnergyDeposit) = dEdx(gen)*length;
+      EDEP_FIELD(seg, float, SecondaryDeposit) = 0.;
+      EDEP_FIELD(seg, float, TrackLength) = length;
+      EDEP_FIELD(seg, TLorentzVector, Start) = start;
+      EDEP_FIELD(seg, TLorentzVector, Stop) = stop;
+      evt.SegmentDetectors[fDetectorNames[detector]].push_back(seg);
+    }
+  }
+
+  void EventGenerator::Write(const std::string& fileName, const size_t nEvents) const
+  {
+    TFile file(fileName.c_str(), "RECREATE");
+    if(file.IsZombie()) throw util::GenException("Synthetic Output") << "Failed to open " << fileName << " for writing.\n";
+
+    auto tree = new TTree("EDepSimEvents", "Synthetic edep-sim events"); //Owned by file
+    std::unique_ptr<TG4Event> evt(new TG4Event());
+    auto evtPtr = evt.get();
+    tree->Branch("Event", &evtPtr);
+
+    for(size_t event = 0; event < nEvents; ++event)
+    {
+      Fill(*evt, event);
+      tree->Fill();
+    }
+
+    file.cd();
+    tree->Write();
+    fGeo->Write("EDepSimGeometry");
+    file.Close();
+  }
+}
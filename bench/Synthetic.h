@@ -0,0 +1,84 @@
+//File: Synthetic.h
+//Brief: An EventGenerator fabricates edep-sim events and a matching simple geometry so that performance tests don't
+//       depend on production files.  Every dimension that drawing plugins scale with can be set independently from a
+//       YAML Synthetic block:
+//
+//       Synthetic:
+//         Seed: 42                  #Events are reproducible for the same Seed and event number
+//         Run: 0                    #RunId of every event
+//         Vertices: 1               #Primary vertices per event
+//         Primaries: 4              #Primary particles per vertex
+//         PointsPerTrajectory: 20   #TG4TrajectoryPoints in every trajectory.  At least 2.
+//         ShowerDepth: 2            #Generations of secondaries below each primary
+//         Children: 2               #Secondaries each trajectory makes in the next generation
+//         SegmentsPerTrajectory: 10 #TG4HitSegments each trajectory leaves
+//         Detectors: 1              #Number of SegmentDetectors.  The detector is split into this many slabs in z.
+//         StepLength: 10            #Distance between trajectory points in mm
+//         DetectorSize: [1000, 1000, 1000] #Half-lengths of the detector in mm
+//
+//       Each event has Vertices*Primaries*(1 + Children + ... + Children^ShowerDepth) trajectories.  Children start
+//       at a random point on their parent like they do in edep-sim.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//yaml-cpp includes
+#include "yaml-cpp/yaml.h"
+
+//c++ includes
+#include <memory>
+#include <string>
+#include <vector>
+#include <random>
+
+#ifndef SYNTH_SYNTHETIC_H
+#define SYNTH_SYNTHETIC_H
+
+class TG4Event;
+class TG4Trajectory;
+class TGeoManager;
+
+namespace synth
+{
+  class EventGenerator
+  {
+    public:
+      EventGenerator(const YAML::Node& config);
+      virtual ~EventGenerator();
+
+      //Replace everything in evt with synthetic event number eventID
+      void Fill(TG4Event& evt, const int eventID) const;
+
+      //Geometry that events are generated in.  Owned by this EventGenerator.
+      TGeoManager* Geometry() const { return fGeo.get(); }
+
+      //Write nEvents events and Geometry() to fileName in the same format as edep-sim so that src::Source can read them
+      void Write(const std::string& fileName, const size_t nEvents) const;
+
+      //Number of trajectories in every event
+      size_t NTrajectories() const;
+
+    private:
+      //Configuration
+      unsigned int fSeed; //Seed for event 0.  Every event gets its' own seed so that events are independent.
+      int fRun; //RunId of every event
+      size_t fVertices; //Primary vertices per event
+      size_t fPrimaries; //Primary particles per vertex
+      size_t fPoints; //TG4TrajectoryPoints per trajectory
+      size_t fShowerDepth; //Generations of secondaries
+      size_t fChildren; //Secondaries per trajectory per generation
+      size_t fSegments; //TG4HitSegments per trajectory
+      size_t fDetectors; //Number of SegmentDetectors
+      double fStepLength; //mm between trajectory points
+      double fHalfSize[3]; //Detector half-lengths in mm
+
+      std::unique_ptr<TGeoManager> fGeo; //Geometry for all events
+      std::vector<std::string> fDetectorNames; //Name of each SegmentDetector's volume
+
+      //Helper functions for Fill()
+      void MakeGeometry();
+      TG4Trajectory& AddTrajectory(TG4Event& evt, const int parentID, const int pdg, const double energy, const double* start,
+                                   const double time, std::mt19937& gen) const;
+      void AddSegments(TG4Event& evt, TG4Trajectory& traj, std::mt19937& gen) const;
+  };
+}
+
+#endif //SYNTH_SYNTHETIC_H
@@ -0,0 +1,446 @@
+//File: Profiler.cpp
+//Brief: Collects CPU and GPU timings for each frame, draws them with Dear imgui, and writes them as a Chrome trace.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//local includes
+#include "gl/Profiler.h"
+#include "util/GenException.h"
+
+//imgui includes
+#include "imgui.h"
+
+//glfw includes
+#include <GLFW/glfw3.h>
+
+//c++ includes
+#include <fstream>
+#include <algorithm>
+#include <numeric>
+#include <cstring>
+#include <cfloat>
+#include <limits>
+
+namespace
+{
+  //Scene and plugin names could have anything in them
+  std::string EscapeJSON(const std::string& str)
+  {
+    std::string escaped;
+    for(const char c: str)
+    {
+      if(c == '"' || c == '\\') escaped += '\\';
+      if(static_cast<unsigned char>(c) >= 0x20) escaped += c;
+    }
+    return escaped;
+  }
+
+  //The value that fraction of values are below.  Sorts values.
+  float Percentile(std::vector<float>& values, const float fraction)
+  {
+    if(values.empty()) return 0;
+    const auto nth = values.begin() + static_cast<size_t>(fraction*(values.size() - 1) + 0.5f);
+    std::nth_element(values.begin(), nth, values.end());
+    return *nth;
+  }
+
+  //EventRecord that Scopes on this thread are Stages of
+  thread_local std::shared_ptr<mygl::Profiler::EventRecord> currentRecord;
+}
+
+namespace mygl
+{
+  constexpr size_t Profiler::nFrames;
+  constexpr size_t Profiler::maxEvents;
+  constexpr size_t Profiler::maxRecords;
+
+  Profiler& Profiler::Instance()
+  {
+    static Profiler profiler;
+    return profiler;
+  }
+
+  Profiler::Profiler(): fOrigin(clock::now()), fNFinished(0), fFrameStart(fOrigin), fFrame(0), fShow(false), fShowMetrics(false), 
+                        fPaused(false), fSelected("Frame"), fStatus(), fSelectedRecord(0)
+  {
+    std::strncpy(fTraceFile, "EvdTrace.json", sizeof(fTraceFile));
+    std::strncpy(fPipelineFile, "EvdPipeline.csv", sizeof(fPipelineFile));
+  }
+
+  Profiler::Scope::Scope(const std::string& name): fName(name), fStart(clock::now())
+  {
+  }
+
+  Profiler::Scope::~Scope()
+  {
+    Profiler::Instance().Record(fName, fStart, clock::now());
+  }
+
+  Profiler::GPUScope::GPUScope(const std::string& name): fTimer(Profiler::Instance().fTimers[name])
+  {
+    fTimer.Begin();
+  }
+
+  Profiler::GPUScope::~GPUScope()
+  {
+    fTimer.End();
+  }
+
+  Profiler::EventScope::EventScope(const std::shared_ptr<EventRecord>& record): fPrevious(currentRecord)
+  {
+    currentRecord = record;
+  }
+
+  Profiler::EventScope::~EventScope()
+  {
+    currentRecord = fPrevious;
+  }
+
+  std::shared_ptr<Profiler::EventRecord> Profiler::QueueEvent()
+  {
+    std::shared_ptr<EventRecord> record(new EventRecord());
+    record->fRun = std::numeric_limits<int>::min();
+    record->fEvent = std::numeric_limits<int>::min();
+    record->fQueued = clock::now();
+    return record;
+  }
+
+  void Profiler::FinishEvent(const std::shared_ptr<EventRecord>& record, const int run, const int event)
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    record->fRun = run;
+    record->fEvent = event;
+    record->fFinished = clock::now();
+
+    //A Stage can happen more than once per event, like once for each Scene
+    std::map<std::string, float> totals;
+    for(const auto& stage: record->fStages) totals[stage.fName] += std::chrono::duration<float, std::milli>(stage.fEnd - stage.fStart).count();
+    totals["Total"] = std::chrono::duration<float, std::milli>(record->fFinished - record->fQueued).count();
+    std::vector<float> sorted;
+    for(const auto& total: totals)
+    {
+      auto& stats = fStageStats[total.first];
+      stats.fMillis.push_back(total.second);
+      if(stats.fMillis.size() > maxRecords) stats.fMillis.pop_front();
+
+      sorted.assign(stats.fMillis.begin(), stats.fMillis.end());
+      stats.fP50 = Percentile(sorted, 0.5f);
+      stats.fP95 = Percentile(sorted, 0.95f);
+    }
+
+    fRecords.push_back(record);
+    if(fRecords.size() > maxRecords) fRecords.pop_front();
+    fSelectedRecord = 0;
+    ++fNFinished;
+  }
+
+  void Profiler::AddStage(const std::shared_ptr<EventRecord>& record, const std::string& name, const clock::time_point start, 
+                          const clock::time_point end)
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    record->fStages.push_back(Stage{name, start, end});
+  }
+
+  long long Profiler::Micros(const clock::time_point time) const
+  {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time - fOrigin).count();
+  }
+
+  size_t Profiler::ThreadIndex()
+  {
+    return fThreads.emplace(std::this_thread::get_id(), fThreads.size()).first->second;
+  }
+
+  void Profiler::BeginFrame()
+  {
+    fFrameStart = clock::now();
+  }
+
+  void Profiler::Record(const std::string& name, const clock::time_point start, const clock::time_point end)
+  {
+    const long long begin = Micros(start), duration = Micros(end) - begin;
+
+    std::lock_guard<std::mutex> lock(fMutex);
+    fCPU[name].fCurrent += duration/1000.f;
+    if(currentRecord) currentRecord->fStages.push_back(Stage{name, start, end});
+    fEvents.push_back(Event{name, begin, duration, ThreadIndex(), 0.f});
+    if(fEvents.size() > maxEvents) fEvents.pop_front();
+  }
+
+  void Profiler::EndFrame()
+  {
+    const auto end = clock::now();
+    const long long begin = Micros(fFrameStart), duration = Micros(end) - begin;
+
+    std::lock_guard<std::mutex> lock(fMutex);
+    const size_t thread = ThreadIndex();
+    fEvents.push_back(Event{"Frame", begin, duration, thread, 0.f});
+
+    //GPU results from a few frames ago.  A GPU Series keeps its last measurement until a newer one arrives.
+    for(auto& timer: fTimers)
+    {
+      GLuint64 nanoseconds;
+      while(timer.second.Poll(nanoseconds))
+      {
+        const float millis = nanoseconds/1e6f;
+        fGPU[timer.first].fCurrent = millis;
+        fEvents.push_back(Event{"GPU " + timer.first, begin, -1, thread, millis});
+      }
+    }
+    while(fEvents.size() > maxEvents) fEvents.pop_front();
+
+    fFrameTime.fCurrent = duration/1000.f;
+    if(!fPaused)
+    {
+      fFrameTime.fMillis[fFrame] = fFrameTime.fCurrent;
+      for(auto& series: fCPU) series.second.fMillis[fFrame] = series.second.fCurrent;
+      for(auto& series: fGPU) series.second.fMillis[fFrame] = series.second.fCurrent;
+      fFrame = (fFrame + 1) % nFrames;
+    }
+    for(auto& series: fCPU) series.second.fCurrent = 0;
+  }
+
+  void Profiler::DrawSeries(const std::string& label, const Series& series, const std::string& name)
+  {
+    bool selected = (fSelected == name);
+    if(ImGui::Selectable(label.c_str(), &selected, ImGuiSelectableFlags_SpanAllColumns)) fSelected = name;
+    ImGui::NextColumn();
+
+    const float last = series.fMillis[(fFrame + nFrames - 1) % nFrames];
+    const float mean = std::accumulate(series.fMillis.begin(), series.fMillis.end(), 0.f)/nFrames;
+    const float max = *std::max_element(series.fMillis.begin(), series.fMillis.end());
+    ImGui::Text("%.3f", last);
+    ImGui::NextColumn();
+    ImGui::Text("%.3f", mean);
+    ImGui::NextColumn();
+    ImGui::Text("%.3f", max);
+    ImGui::NextColumn();
+  }
+
+  void Profiler::Render()
+  {
+    if(ImGui::IsKeyPressed(GLFW_KEY_F2, false)) fShow = !fShow;
+    if(fShowMetrics) ImGui::ShowMetricsWindow(&fShowMetrics);
+    if(!fShow) return;
+
+    ImGui::SetNextWindowSize(ImVec2(450, 450), ImGuiCond_FirstUseEver);
+    if(!ImGui::Begin("Profiler", &fShow))
+    {
+      ImGui::End();
+      return;
+    }
+
+    ImGui::Checkbox("Pause", &fPaused);
+    ImGui::SameLine();
+    ImGui::Checkbox("Dear imgui Metrics", &fShowMetrics);
+
+    RenderFrames();
+    RenderPipeline();
+
+    if(!fStatus.empty())
+    {
+      ImGui::Separator();
+      ImGui::TextWrapped("%s", fStatus.c_str());
+    }
+
+    ImGui::End();
+  }
+
+  void Profiler::RenderFrames()
+  {
+    if(!ImGui::CollapsingHeader("Frames", ImGuiTreeNodeFlags_DefaultOpen)) return;
+
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+
+      //Rolling graph of the selected timing
+      const Series* graph = &fFrameTime;
+      if(fSelected.compare(0, 4, "CPU ") == 0 && fCPU.count(fSelected.substr(4))) graph = &fCPU[fSelected.substr(4)];
+      else if(fSelected.compare(0, 4, "GPU ") == 0 && fGPU.count(fSelected.substr(4))) graph = &fGPU[fSelected.substr(4)];
+      else fSelected = "Frame";
+      ImGui::PlotLines("##Timing", graph->fMillis.data(), nFrames, fFrame, (fSelected + " [ms]").c_str(), 0.f, FLT_MAX,
+                       ImVec2(ImGui::GetContentRegionAvailWidth(), 100));
+
+      //Table of every timing.  Click a row to graph it.
+      ImGui::Separator();
+      ImGui::Columns(4, "Timings");
+      ImGui::Text("Timing");
+      ImGui::NextColumn();
+      ImGui::Text("Last [ms]");
+      ImGui::NextColumn();
+      ImGui::Text("Mean [ms]");
+      ImGui::NextColumn();
+      ImGui::Text("Max [ms]");
+      ImGui::NextColumn();
+      ImGui::Separator();
+
+      DrawSeries("Frame", fFrameTime, "Frame");
+      for(const auto& series: fCPU) DrawSeries(series.first, series.second, "CPU " + series.first);
+      for(const auto& series: fGPU) DrawSeries("GPU: " + series.first, series.second, "GPU " + series.first);
+      ImGui::Columns(1);
+    }
+
+    //Chrome trace for offline analysis
+    ImGui::Separator();
+    ImGui::InputText("Trace File", fTraceFile, sizeof(fTraceFile));
+    if(ImGui::Button("Dump Trace"))
+    {
+      try
+      {
+        WriteTrace(fTraceFile);
+        fStatus = std::string("Wrote ") + fTraceFile;
+      }
+      catch(const util::GenException& e)
+      {
+        fStatus = e.what();
+      }
+    }
+  }
+
+  void Profiler::RenderPipeline()
+  {
+    if(!ImGui::CollapsingHeader("Event Pipeline")) return;
+
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      if(fRecords.empty())
+      {
+        ImGui::Text("No events have been loaded yet.");
+        return;
+      }
+
+      //Timeline of one event.  Each Stage name gets its own row.
+      int selected = std::min(fSelectedRecord, fRecords.size() - 1);
+      ImGui::SliderInt("Events Ago", &selected, 0, fRecords.size() - 1);
+      fSelectedRecord = selected;
+      const auto& record = *fRecords[fRecords.size() - 1 - fSelectedRecord];
+      const auto millis = [&record](const clock::time_point time) 
+                          { 
+                            return std::chrono::duration<float, std::milli>(time - record.fQueued).count(); 
+                          };
+      const float total = std::max(millis(record.fFinished), 1e-3f);
+      ImGui::Text("Run %d, Event %d: %.1f ms from Source to screen", record.fRun, record.fEvent, total);
+
+      std::vector<std::string> rows;
+      std::vector<const Stage*> byStart;
+      for(const auto& stage: record.fStages) byStart.push_back(&stage);
+      std::sort(byStart.begin(), byStart.end(), [](const Stage* lhs, const Stage* rhs) { return lhs->fStart < rhs->fStart; });
+      for(const auto stage: byStart) if(std::find(rows.begin(), rows.end(), stage->fName) == rows.end()) rows.push_back(stage->fName);
+
+      const float labelWidth = 180.f, rowHeight = ImGui::GetTextLineHeightWithSpacing();
+      const float width = std::max(ImGui::GetContentRegionAvailWidth() - labelWidth, 50.f);
+      const ImVec2 origin = ImGui::GetCursorScreenPos();
+      auto draw = ImGui::GetWindowDrawList();
+      for(size_t row = 0; row < rows.size(); ++row)
+      {
+        draw->AddText(ImVec2(origin.x, origin.y + row*rowHeight), ImGui::GetColorU32(ImGuiCol_Text), rows[row].c_str());
+      }
+
+      for(const auto stage: byStart)
+      {
+        const size_t row = std::find(rows.begin(), rows.end(), stage->fName) - rows.begin();
+        const float start = millis(stage->fStart), end = millis(stage->fEnd);
+        const ImVec2 min(origin.x + labelWidth + width*start/total, origin.y + row*rowHeight + 1.f);
+        const ImVec2 max(std::max(min.x + 1.f, origin.x + labelWidth + width*end/total), origin.y + (row+1)*rowHeight - 1.f);
+        const bool hovered = ImGui::IsMouseHoveringRect(min, max);
+        draw->AddRectFilled(min, max, ImGui::GetColorU32(hovered?ImGuiCol_PlotHistogramHovered:ImGuiCol_PlotHistogram));
+        if(hovered) ImGui::SetTooltip("%s\n%.3f ms starting at %.3f ms", stage->fName.c_str(), end - start, start);
+      }
+      ImGui::Dummy(ImVec2(labelWidth + width, rows.size()*rowHeight));
+
+      //Statistics over recent events
+      ImGui::Separator();
+      ImGui::Text("%zu events this session.  Statistics from the last %zu.", fNFinished, std::min(fNFinished, maxRecords));
+      ImGui::Columns(3, "Stages");
+      ImGui::Text("Stage");
+      ImGui::NextColumn();
+      ImGui::Text("p50 [ms]");
+      ImGui::NextColumn();
+      ImGui::Text("p95 [ms]");
+      ImGui::NextColumn();
+      ImGui::Separator();
+      for(const auto& stage: fStageStats)
+      {
+        ImGui::Text("%s", stage.first.c_str());
+        ImGui::NextColumn();
+        ImGui::Text("%.3f", stage.second.fP50);
+        ImGui::NextColumn();
+        ImGui::Text("%.3f", stage.second.fP95);
+        ImGui::NextColumn();
+      }
+      ImGui::Columns(1);
+    }
+
+    ImGui::Separator();
+    ImGui::InputText("Pipeline File", fPipelineFile, sizeof(fPipelineFile));
+    if(ImGui::Button("Export Pipeline"))
+    {
+      try
+      {
+        WritePipeline(fPipelineFile);
+        fStatus = std::string("Wrote ") + fPipelineFile;
+      }
+      catch(const util::GenException& e)
+      {
+        fStatus = e.what();
+      }
+    }
+  }
+
+  void Profiler::WritePipeline(const std::string& fileName)
+  {
+    std::deque<std::shared_ptr<EventRecord>> records;
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      records = fRecords;
+    }
+
+    std::ofstream csv(fileName);
+    if(!csv) throw util::GenException("Profiler") << "Couldn't open " << fileName << " to write event pipeline timings.\n";
+
+    csv << "run,event,stage,start [ms],duration [ms]\n";
+    for(const auto& record: records)
+    {
+      const auto millis = [&record](const clock::time_point time) 
+                          { 
+                            return std::chrono::duration<float, std::milli>(time - record->fQueued).count(); 
+                          };
+      for(const auto& stage: record->fStages)
+      {
+        csv << record->fRun << "," << record->fEvent << ",\"" << stage.fName << "\"," << millis(stage.fStart) << "," 
+            << millis(stage.fEnd) - millis(stage.fStart) << "\n";
+      }
+      csv << record->fRun << "," << record->fEvent << ",\"Total\",0," << millis(record->fFinished) << "\n";
+    }
+
+    if(!csv) throw util::GenException("Profiler") << "Failed while writing event pipeline timings to " << fileName << ".\n";
+  }
+
+  void Profiler::ReleaseGPU()
+  {
+    fTimers.clear();
+  }
+
+  void Profiler::WriteTrace(const std::string& fileName)
+  {
+    std::deque<Event> events;
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      events = fEvents;
+    }
+
+    std::ofstream trace(fileName);
+    if(!trace) throw util::GenException("Profiler") << "Couldn't open " << fileName << " to write a trace.\n";
+
+    trace << "{\"traceEvents\":[\n";
+    for(auto event = events.begin(); event != events.end(); ++event)
+    {
+      if(event != events.begin()) trace << ",\n";
+      trace << "{\"name\":\"" << EscapeJSON(event->fName) << "\",\"pid\":0,\"tid\":" << event->fThread << ",\"ts\":" << event->fStart;
+      if(event->fDuration >= 0) trace << ",\"ph\":\"X\",\"dur\":" << event->fDuration << "}";
+      else trace << ",\"ph\":\"C\",\"args\":{\"ms\":" << event->fValue << "}}";
+    }
+    trace << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    if(!trace) throw util::GenException("Profiler") << "Failed while writing a trace to " << fileName << ".\n";
+  }
+}
@@ -0,0 +1,191 @@
+//File: Profiler.h
+//Brief: A Profiler records how long each part of drawing a frame takes.  Time a block of code on the CPU by making a
+//       Profiler::Scope at the top of it, and time the GPU commands it sends with a Profiler::GPUScope.  Timings are
+//       summed by name in each frame and kept for the last few hundred frames.  Render() draws an overlay with a
+//       rolling graph of any timing and a button to write the most recent events as a Chrome trace (load it in
+//       chrome://tracing or https://ui.perfetto.dev).  Press F2 to show or hide the overlay.
+//
+//       The Profiler also follows each event through the pipeline from its Source to the screen.  QueueEvent() starts an
+//       EventRecord, and every Scope made on a thread where an EventScope is bound to that EventRecord becomes one of its
+//       stages.  FinishEvent() adds the EventRecord to the Event Pipeline timeline and statistics in the overlay.
+//
+//       There is one Profiler per application so that code anywhere in the event display can time itself without
+//       being handed a Profiler.  Scopes can be used from any thread, but GPUScopes only from the thread with the
+//       opengl context, and GPUScopes can't be nested.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef MYGL_PROFILER_H
+#define MYGL_PROFILER_H
+
+//local includes
+#include "gl/objects/TimerQuery.h"
+
+//c++ includes
+#include <string>
+#include <map>
+#include <deque>
+#include <vector>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <memory>
+
+namespace mygl
+{
+  class Profiler
+  {
+    public:
+      using clock = std::chrono::steady_clock;
+
+      static Profiler& Instance(); //The Profiler for this application
+
+      //Time from construction to destruction on the CPU
+      class Scope
+      {
+        public:
+          Scope(const std::string& name);
+          ~Scope();
+
+        private:
+          std::string fName;
+          clock::time_point fStart;
+      };
+
+      //Time the GPU takes to draw everything sent between construction and destruction
+      class GPUScope
+      {
+        public:
+          GPUScope(const std::string& name);
+          ~GPUScope();
+
+        private:
+          TimerQuery& fTimer;
+      };
+
+      //One step in getting an event on screen
+      struct Stage
+      {
+        std::string fName;
+        clock::time_point fStart;
+        clock::time_point fEnd;
+      };
+
+      //Every Stage of one event from when it was requested from a Source to when it was loaded into Scenes
+      struct EventRecord
+      {
+        int fRun;
+        int fEvent;
+        clock::time_point fQueued; //When QueueEvent() was called
+        clock::time_point fFinished; //When FinishEvent() was called
+        std::vector<Stage> fStages; //In the order they finished
+      };
+
+      //Scopes on this thread are Stages of record until this EventScope is destroyed
+      class EventScope
+      {
+        public:
+          EventScope(const std::shared_ptr<EventRecord>& record);
+          ~EventScope();
+
+        private:
+          std::shared_ptr<EventRecord> fPrevious; //EventRecord bound before this EventScope
+      };
+
+      std::shared_ptr<EventRecord> QueueEvent(); //Start timing a new event
+      void FinishEvent(const std::shared_ptr<EventRecord>& record, const int run, const int event); //The event is on screen
+
+      //Add a Stage to record that isn't CPU time on one thread, like waiting for an event.  Safe to call from any thread.
+      void AddStage(const std::shared_ptr<EventRecord>& record, const std::string& name, const clock::time_point start, 
+                    const clock::time_point end);
+
+      //The application's main loop calls these around each frame
+      void BeginFrame();
+      void EndFrame(); //Also collects GPU timings that have finished
+
+      //Add a CPU timing.  Safe to call from any thread.
+      void Record(const std::string& name, const clock::time_point start, const clock::time_point end);
+
+      //Draw the profiler overlay if it is visible.  Handles the F2 key.
+      void Render();
+
+      bool& Show() { return fShow; } //Is the overlay visible?
+      bool NeedsFrame() const { return fShow && !fPaused; } //The overlay's graphs only move if frames are drawn continuously
+
+      //Write recorded events to fileName in the Chrome trace JSON format.  Throws a util::GenException if fileName
+      //can't be written.
+      void WriteTrace(const std::string& fileName);
+
+      //Write every Stage of the most recent finished events to fileName as comma-separated values.  Throws a util::GenException if
+      //fileName can't be written.
+      void WritePipeline(const std::string& fileName);
+
+      //Delete GPU timers.  Call this before the opengl context is destroyed because the Profiler outlives it.
+      void ReleaseGPU();
+
+    private:
+      Profiler();
+
+      static constexpr size_t nFrames = 300; //Frames of history kept for each timing
+      static constexpr size_t maxEvents = 1 << 16; //Most events kept for WriteTrace()
+      static constexpr size_t maxRecords = 1000; //Most EventRecords kept for the timeline and WritePipeline()
+
+      //One timing's history in milliseconds.  fMillis is a ring buffer with the newest frame just before fFrame.
+      struct Series
+      {
+        Series(): fMillis(nFrames, 0), fCurrent(0) {}
+
+        std::vector<float> fMillis; //Total time in each recent frame
+        float fCurrent; //Total time so far in the current frame
+      };
+
+      //One CPU timing or GPU measurement for WriteTrace()
+      struct Event
+      {
+        std::string fName;
+        long long fStart; //Microseconds since this Profiler was created
+        long long fDuration; //Microseconds.  Negative for GPU times that are written as counters.
+        size_t fThread; //Small integer for each thread that has recorded an event
+        float fValue; //Milliseconds of GPU time for counters
+      };
+
+      long long Micros(const clock::time_point time) const;
+      size_t ThreadIndex(); //Small integer for the calling thread.  Lock fMutex first.
+      void DrawSeries(const std::string& label, const Series& series, const std::string& name);
+      void RenderFrames(); //Timings for each frame
+      void RenderPipeline(); //Timeline and statistics for each event
+
+      std::mutex fMutex; //Protects everything below that Record() touches
+      clock::time_point fOrigin; //When this Profiler was created
+      std::map<std::string, Series> fCPU; //CPU time per name
+      std::deque<Event> fEvents; //Most recent events for WriteTrace()
+      std::map<std::thread::id, size_t> fThreads; //Small integer for each thread in fEvents
+      std::deque<std::shared_ptr<EventRecord>> fRecords; //Most recent finished events
+      //Recent history of one Stage with percentiles updated by FinishEvent() so that the overlay doesn't sort every frame
+      struct StageStats
+      {
+        std::deque<float> fMillis; //Total time in this Stage for each of the last maxRecords events that had it
+        float fP50;
+        float fP95;
+      };
+      std::map<std::string, StageStats> fStageStats; //Statistics for each Stage name
+      size_t fNFinished; //Events finished this session
+
+      std::map<std::string, TimerQuery> fTimers; //GPU timer for each GPUScope name
+      std::map<std::string, Series> fGPU; //GPU time per name
+      Series fFrameTime; //Time between BeginFrame() and EndFrame()
+      clock::time_point fFrameStart; //When BeginFrame() was last called
+      size_t fFrame; //Position of the current frame in each Series
+
+      //Overlay state
+      bool fShow; //Draw the overlay?
+      bool fShowMetrics; //Also draw Dear imgui's metrics window?
+      bool fPaused; //Stop updating the overlay so that a frame can be inspected
+      std::string fSelected; //Name of the timing to graph.  Prefixed with "CPU " or "GPU ".
+      char fTraceFile[256]; //File name for WriteTrace() from the overlay
+      std::string fStatus; //Result of the last WriteTrace() from the overlay
+      size_t fSelectedRecord; //Position in fRecords counting back from the newest event to draw on the timeline
+      char fPipelineFile[256]; //File name for WritePipeline() from the overlay
+  };
+}
+
+#endif //MYGL_PROFILER_H
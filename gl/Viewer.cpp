@@ -9,6 +9,7 @@
 //local includes
 #include "gl/Viewer.h"
 #include "gl/camera/Camera.h"
+#include "gl/Profiler.h"
 
 //imgui includes
 #include "imgui.h"
@@ -30,7 +31,11 @@ namespace mygl
                 fCurrentScene(fSceneMap.end()),
                 fBackgroundColor(0., 0., 0.),
                 fCameras(), 
-                fXPerPixel(xPerPixel), fYPerPixel(yPerPixel), fZPerPixel(zPerPixel)
+                fXPerPixel(xPerPixel), fYPerPixel(yPerPixel), fZPerPixel(zPerPixel), 
+                fIDBuffer(GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT), fIDReadback(), fIDValid(false), fIDGeneration(0), fPickRequested(false), fPickX(0), fPickY(0),
+                fPickIsClick(false), fInFlightIsClick(false), fHoverPick(false), fHoverValid(false), fHoverID(), 
+                fHoverRequested(false), fHoverX(0), fHoverY(0), fHoverWidth(0), fHoverHeight(0), fHoverGeneration(0),
+                fCPUPicking(false), fPickRadius(3.)
   {
     fDefaultCamera = std::move(cam);
     LoadCameras(); 
@@ -56,6 +61,7 @@ namespace mygl
     ImGui::Columns(fSceneMap.size()+1);
 
     //Render selectable text for each Scene.  Basically, a poor-man's tab widget.
+    const auto previousScene = fCurrentScene;
     bool selected = (fCurrentScene == fSceneMap.end());
     ImGui::Selectable("Viewer", &selected);
     ImGui::NextColumn();
@@ -71,9 +77,14 @@ namespace mygl
       ImGui::NextColumn();
     }
     ImGui::Columns(1);
+    if(previousScene != fCurrentScene && previousScene != fSceneMap.end()) previousScene->second.HideGUI();
 
     ImGui::Separator();
-    if(fCurrentScene != fSceneMap.end()) fCurrentScene->second.RenderGUI();
+    if(fCurrentScene != fSceneMap.end())
+    {
+      Profiler::Scope timer("RenderGUI " + fCurrentScene->first);
+      fCurrentScene->second.RenderGUI();
+    }
     else //Render Viewer controls
     {
       //A button to select the current Camera
@@ -94,6 +105,15 @@ namespace mygl
       ImGui::Text("Viewer Controls");
       ImGui::Separator();
       ImGui::ColorEdit3("Choose a Background", glm::value_ptr(fBackgroundColor));
+      if(ImGui::Checkbox("Show Object Under Mouse", &fHoverPick)) fHoverValid = fHoverRequested = false;
+      if(ImGui::Checkbox("Pick Objects on CPU", &fCPUPicking))
+      {
+        for(auto& scenePair: fSceneMap) scenePair.second.EnableCPUPicking(fCPUPicking);
+        fHoverValid = fHoverRequested = false;
+      }
+      if(ImGui::IsItemHovered()) ImGui::SetTooltip("Find clicked objects by casting a ray instead of drawing them again.\n"
+                                                   "Uses more memory and some time to set up for each event.");
+      ImGui::Checkbox("Show Profiler (F2)", &Profiler::Instance().Show());
       //TODO: Am I missing any controls?  Please let me know if you have requests!
     }
     ImGui::End();    
@@ -101,10 +121,61 @@ namespace mygl
     //Send mouse and keyboard events to the current Camera
     GetCurrentCamera()->update(ioState);
 
+    //Apply any selections that the GPU has finished
+    ResolvePick();
+
     //TODO: Dont' adjust camera if handled a click here
     if(!ioState.WantCaptureMouse && ImGui::IsMouseClicked(0)) on_click(0, ioState.MousePos.x, ioState.MousePos.y, width, height);
+    else if(fHoverPick && !ioState.WantCaptureMouse && !ioState.MouseDown[0]
+            && NeedsHoverPick(ioState.MousePos.x, ioState.MousePos.y, width, height))
+    {
+      //Cheap as long as fIDBuffer is up to date: just one pixel is read back
+      RequestPick(ioState.MousePos.x, ioState.MousePos.y, width, height, false);
+    }
+
+    if(fHoverPick && fHoverValid && !ioState.WantCaptureMouse)
+    {
+      for(auto& scenePair: fSceneMap) if(scenePair.second.RenderTooltip(fHoverID)) break;
+    }
 
     render(width, height);
+
+    if(fPickRequested && !fIDReadback.Pending()) IssuePick(width, height);
+  }
+
+  bool Viewer::NeedsHoverPick(const float x, const float y, const int width, const int height)
+  {
+    if(fPickRequested && fPickIsClick) return false; //RequestPick() would drop a hover pick now anyway
+
+    const auto view = GetCurrentCamera()->GetView();
+    const auto persp = GetCurrentCamera()->GetPerspective(width, height);
+    const size_t generation = SceneGeneration();
+    if(fHoverRequested && x == fHoverX && y == fHoverY && width == fHoverWidth && height == fHoverHeight 
+       && view == fHoverView && persp == fHoverPersp && generation == fHoverGeneration) return false;
+
+    fHoverRequested = true;
+    fHoverX = x;
+    fHoverY = y;
+    fHoverWidth = width;
+    fHoverHeight = height;
+    fHoverView = view;
+    fHoverPersp = persp;
+    fHoverGeneration = generation;
+    return true;
+  }
+
+  size_t Viewer::SceneGeneration() const
+  {
+    size_t generation = 0;
+    for(const auto& scenePair: fSceneMap) generation += scenePair.second.Generation();
+    return generation;
+  }
+
+  bool Viewer::NeedsFrame() const
+  {
+    if(fPickRequested || fIDReadback.Pending()) return true;
+    for(const auto& scenePair: fSceneMap) if(scenePair.second.NeedsFrame()) return true;
+    return false;
   }
 
   //TODO: The next two functions move to the .h file when this becomes a function template
@@ -152,7 +223,7 @@ namespace mygl
   {
   }
 
-  void Viewer::render(const int width, const int height) 
+  void Viewer::render(const int width, const int height, const glm::mat4& tile) 
   {
     glClearColor(fBackgroundColor.x, fBackgroundColor.y, fBackgroundColor.z, 1.0);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -161,10 +232,50 @@ namespace mygl
     for(auto& scenePair: fSceneMap)
     {
       const auto view = GetCurrentCamera()->GetView();
-      scenePair.second.Render(view, GetCurrentCamera()->GetPerspective(width, height));
+      Profiler::Scope cpuTimer("Render " + scenePair.first);
+      Profiler::GPUScope gpuTimer(scenePair.first);
+      scenePair.second.Render(view, tile*GetCurrentCamera()->GetPerspective(width, height));
     }
   }
   
+  void Viewer::RenderScenes(const int width, const int height)
+  {
+    render(width, height);
+  }
+
+  void Viewer::RenderTile(const int width, const int height, const int tileX, const int tileY, const int tileWidth, const int tileHeight)
+  {
+    //Stretch the tile's part of normalized device coordinates over the whole viewport.  The tile spans 
+    //[2*tileX/width - 1, 2*(tileX+tileWidth)/width - 1] in x, and likewise in y.
+    const glm::vec2 scale((float)width/tileWidth, (float)height/tileHeight);
+    const glm::vec2 offset(scale.x - 1.f - 2.f*tileX/tileWidth, scale.y - 1.f - 2.f*tileY/tileHeight);
+    const auto tile = glm::scale(glm::translate(glm::mat4(1.f), glm::vec3(offset, 0.f)), glm::vec3(scale, 1.f));
+    render(width, height, tile);
+  }
+
+  void Viewer::SetCamera(const std::string& name)
+  {
+    const auto found = fCameras.find(name);
+    if(found == fCameras.end())
+    {
+      util::GenException e("Camera Not Found");
+      e << "In mygl::Viewer::SetCamera(), there is no Camera named " << name << ".  Cameras for this event are:\n";
+      for(const auto& cam: fCameras) e << cam.first << "\n";
+      throw e;
+    }
+    fCurrentCamera = found;
+  }
+
+  void Viewer::SetCut(const std::string& sceneName, const std::string& cut)
+  {
+    const auto found = fSceneMap.find(sceneName);
+    if(found == fSceneMap.end())
+    {
+      throw util::GenException("Scene Not Found") << "In mygl::Viewer::SetCut(), there is no Scene named " << sceneName << ".\n";
+    }
+    found->second.SetCut(cut);
+  }
+
   void Viewer::LoadCameras(std::map<std::string, std::unique_ptr<mygl::Camera>>&& cameraToName)
   {
     fCameras = std::move(cameraToName);
@@ -181,39 +292,138 @@ namespace mygl
   {
     if(button != 0) return false; //button 1 is the left mouse button
     
+    RequestPick(x, y, width, height, true);
+    fHoverRequested = false; //A click replaces any hover pick that hasn't been read back yet
+    return true;
+  }
+
+  void Viewer::RequestPick(const float x, const float y, const int width, const int height, const bool click)
+  {
+    if(fCPUPicking)
+    {
+      VisID id = VisID::None(); //Same as the background of fIDBuffer
+      Pick(MakeRay(x, y, width, height), width, height, id);
+      ApplyPick(id, click);
+      return;
+    }
+
+
+    //A click is never replaced by a hover
+    if(fPickRequested && fPickIsClick && !click) return;
+
+    fPickX = x;
+    fPickY = height-y;
+    fPickIsClick = click;
+    fPickRequested = true;
+  }
+
+  void Viewer::IssuePick(const int width, const int height)
+  {
+    fPickRequested = false;
+    if(fPickX < 0 || fPickX >= width || fPickY < 0 || fPickY >= height) return;
+
+    UpdateIDBuffer(width, height);
+
+    //Method for reading pixels taken from http://www.opengl-tutorial.org/miscellaneous/clicking-on-objects/picking-with-an-opengl-hack/
+    //The pixel is copied into fIDReadback on the GPU, so there's no need to glFinish() here.
+    fIDBuffer.Use();
+    fIDReadback.Read(fPickX, fPickY, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, sizeof(uint32_t));
+    Framebuffer::Default();
+    fInFlightIsClick = fPickIsClick;
+  }
+
+  void Viewer::ResolvePick()
+  {
+    if(!fIDReadback.Ready()) return;
+
+    mygl::VisID id;
+    if(!fIDReadback.Map(&id.fID)) return;
+
+    ApplyPick(id, fInFlightIsClick);
+  }
+
+  void Viewer::ApplyPick(const VisID& id, const bool click)
+  {
+    //React to the user's selection.  Ultimately, I want to propagate this to other Viewers, so emit a signal that Viewers 
+    //and/or Scenes can react to.  
+    //TODO: Selection object like Gtk::TreeView::Selection instead of emitting a signal here?  
+    //      I would want a way for multiple Viewers to post events to this Selection object.  
+    if(click) on_selection(id);
+    else
+    {
+      fHoverID = id;
+      fHoverValid = true;
+    }
+  }
+
+  bool Viewer::Pick(const BVH::Ray& ray, const int width, const int height, VisID& id)
+  {
+    const auto view = GetCurrentCamera()->GetView();
+    const auto persp = GetCurrentCamera()->GetPerspective(width, height);
+    float distance;
+    for(auto scenePair = fSceneMap.rbegin(); scenePair != fSceneMap.rend(); ++scenePair)
+    {
+      if(scenePair->second.Pick(ray, view, persp, width, height, id, distance)) return true;
+    }
+    return false;
+  }
+
+  BVH::Ray Viewer::MakeRay(const float x, const float y, const int width, const int height)
+  {
+    const auto inverse = glm::inverse(GetCurrentCamera()->GetPerspective(width, height)*GetCurrentCamera()->GetView());
+    const auto unproject = [&inverse](const float ndcX, const float ndcY, const float ndcZ)
+                           {
+                             const auto world = inverse*glm::vec4(ndcX, ndcY, ndcZ, 1.f);
+                             return glm::vec3(world)/world.w;
+                           };
+
+    //Ray from the near plane to the far plane through this pixel
+    const float ndcX = 2.f*x/width - 1.f, ndcY = 1.f - 2.f*y/height, ndcRadius = 2.f*fPickRadius/width;
+    const auto near = unproject(ndcX, ndcY, -1.f), far = unproject(ndcX, ndcY, 1.f);
+
+    BVH::Ray ray;
+    ray.fOrigin = near;
+    ray.fLength = glm::length(far - near);
+    ray.fDirection = (far - near)/ray.fLength;
+
+    //fPickRadius pixels is a different distance at each end of the ray for a perspective projection
+    ray.fRadius = glm::length(unproject(ndcX + ndcRadius, ndcY, -1.f) - near);
+    ray.fRadiusSlope = (glm::length(unproject(ndcX + ndcRadius, ndcY, 1.f) - far) - ray.fRadius)/ray.fLength;
+
+    return ray;
+  }
+
+  void Viewer::UpdateIDBuffer(const int width, const int height)
+  {
+    const auto view = GetCurrentCamera()->GetView();
+    const auto persp = GetCurrentCamera()->GetPerspective(width, height);
+    const size_t generation = SceneGeneration();
+
+    const bool resized = fIDBuffer.Resize(width, height);
+    if(fIDValid && !resized && view == fIDView && persp == fIDPersp && generation == fIDGeneration) return;
+
+    fIDBuffer.Use();
+
     //TODO: Encapsulate "global" opengl settings into an object that can apply defaults here
     glDisable(GL_BLEND);
-    glClearColor(1.0f, 1.0f, 1.0f, 1.0f); //TODO: Make sure there is no VisID that maps to this color.  
-                                              
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    const GLuint none = VisID::None().fID; //Integer framebuffers can't be cleared with glClearColor()
+    glClearBufferuiv(GL_COLOR, 0, &none);
+    glClear(GL_DEPTH_BUFFER_BIT);
  
     for(auto& scenePair: fSceneMap)
     {
-      const auto view = GetCurrentCamera()->GetView();
- 
       //TODO: It would be great to be able to change out this selection algorithm.  
-      scenePair.second.RenderSelection(view, GetCurrentCamera()->GetPerspective(width, height));
-      //I am not requesting a render here because I want to wait until reacting to the user's selection before rendering.  
+      scenePair.second.RenderSelection(view, persp);
     }
-    glFlush();
   
     //TODO: Class/struct to encapsulate an opengl drawing state
     glEnable(GL_BLEND);
+    Framebuffer::Default();
 
-    //Method for reading pixels taken from http://www.opengl-tutorial.org/miscellaneous/clicking-on-objects/picking-with-an-opengl-hack/
-    glFinish(); //Wait for all drawing to finish
-    glPixelStorei(GL_PACK_ALIGNMENT, 1); 
-    unsigned char color[4];
-    glReadPixels(x, height-y, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, color); 
-
-    //React to the user's selection.  Ultimately, I want to propagate this to other Viewers, so emit a signal that Viewers 
-    //and/or Scenes can react to.  
-    //TODO: Selection object like Gtk::TreeView::Selection instead of emitting a signal here?  
-    //      I would want a way for multiple Viewers to post events to this Selection object.  
-    //fSignalSelection.emit(mygl::VisID(color[0], color[1], color[2])); //, evt->x, evt->y); 
-    on_selection(mygl::VisID(color[0], color[1], color[2]));
-
-    return true;
+    fIDValid = true;
+    fIDView = view;
+    fIDPersp = persp;
+    fIDGeneration = generation;
   }
 
   /*Viewer::SignalSelection Viewer::signal_selection()
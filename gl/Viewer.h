@@ -14,6 +14,9 @@
 #include "gl/scene/SceneController.h"
 #include "util/GenException.h"
 #include "gl/scene/SceneConfig.cpp"
+#include "gl/objects/Framebuffer.h"
+#include "gl/objects/PixelBuffer.h"
+#include "gl/selection/VisID.h"
 
 //glm includes
 #include <glm/glm.hpp>
@@ -33,8 +36,6 @@ namespace ctrl
 
 namespace mygl
 {
-  struct VisID;
-  
   class Viewer
   {
     protected:
@@ -63,12 +64,38 @@ namespace mygl
       void LoadCameras(std::map<std::string, std::unique_ptr<mygl::Camera>>&& cameraToName = std::map<std::string, std::unique_ptr<Camera>>());
 
       //User interaction 
-      bool on_click(const int button, const float x, const float y, const int width, const int height); //Handle user selection of drawn objects
+      //Handle user selection of drawn objects.  The selection is applied in a later frame once the GPU has found it.
+      bool on_click(const int button, const float x, const float y, const int width, const int height); 
 
       void on_selection(const mygl::VisID id/*, const int, const int*/);
 
+      //CPU picking that doesn't need a framebuffer.  Find the object along ray in the Scene that is drawn last.  Scenes 
+      //are checked in the reverse of the order they are Render()ed in because later Scenes are drawn on top.  Only 
+      //objects that the current Camera would draw in a width x height viewport can be hit.  Returns whether anything was hit.
+      bool Pick(const BVH::Ray& ray, const int width, const int height, VisID& id);
+
+      //Ray from the current Camera through pixel (x, y) measured from the top left of a width x height viewport.  Hits 
+      //line segments and points within fPickRadius pixels.
+      BVH::Ray MakeRay(const float x, const float y, const int width, const int height);
+
       //Application/main window calls this in each frame
       void Render(const int width, const int height, const ImGuiIO& ioState); 
+
+      //Would drawing a frame now change anything without new input?  True while a pick is being read back or a Scene 
+      //finished something in the background.
+      bool NeedsFrame() const;
+
+      //Batch rendering without a user.  RenderScenes() draws every Scene into the current Framebuffer without any GUI.  
+      //SetCamera() and SetCut() throw a util::GenException if name isn't a Camera or Scene.  LoadCameras() forgets 
+      //SetCamera(), but SetCut() lasts for future events.
+      void RenderScenes(const int width, const int height);
+      void SetCamera(const std::string& name);
+
+      //Draw only the tileWidth x tileHeight pixels starting at (tileX, tileY) from the bottom left of what RenderScenes(width, 
+      //height) would draw.  Set the viewport to tileWidth x tileHeight first.  Tiles let images be printed at resolutions
+      //larger than the screen or a Framebuffer supports.
+      void RenderTile(const int width, const int height, const int tileX, const int tileY, const int tileWidth, const int tileHeight);
+      void SetCut(const std::string& sceneName, const std::string& cut);
  
     protected:
       //Viewer parameters the user can customize
@@ -77,7 +104,8 @@ namespace mygl
       virtual void area_realize();
       virtual void unrealize();
 
-      virtual void render(const int width, const int height);
+      //tile is applied after the Camera's projection matrix to draw just part of the view
+      virtual void render(const int width, const int height, const glm::mat4& tile = glm::mat4(1.f));
 
       //Switched to a std::list here so that iterators are valid even after insertions and deletions
       std::map<std::string, std::unique_ptr<Camera>> fCameras;
@@ -94,6 +122,47 @@ namespace mygl
 
       void PrepareToAddScene(const std::string& name);
       void ConfigureNewScene(const std::string& name, ctrl::SceneController& scene, ctrl::ColumnModel& cols);      
+
+      //Object selection.  Every Scene is drawn with RenderSelection() into fIDBuffer only when something that would change 
+      //it has changed.  Pixels are read back from fIDBuffer through fIDReadback so that selection never waits on the GPU.
+      void RequestPick(const float x, const float y, const int width, const int height, const bool click); //Ask for the VisID under (x, y)
+      void IssuePick(const int width, const int height); //Start reading back the last RequestPick()
+      void ResolvePick(); //Apply a pick that the GPU has finished
+      void UpdateIDBuffer(const int width, const int height); //Draw fIDBuffer again if it is out of date
+      void ApplyPick(const VisID& id, const bool click); //React to a finished pick
+
+      Framebuffer fIDBuffer; //Every Scene drawn with a unique integer for each VisID
+      PixelBuffer fIDReadback; //One pixel from fIDBuffer
+      bool fIDValid; //Has fIDBuffer ever been drawn?
+      glm::mat4 fIDView; //View matrix when fIDBuffer was drawn
+      glm::mat4 fIDPersp; //Projection matrix when fIDBuffer was drawn
+      size_t fIDGeneration; //Sum of Scene Generation()s when fIDBuffer was drawn
+
+      bool fPickRequested; //Is there a pick that hasn't been sent to fIDReadback yet?
+      int fPickX; //Pixel coordinates of requested pick
+      int fPickY;
+      bool fPickIsClick; //Is the requested pick a click?  Otherwise, it's a hover.
+      bool fInFlightIsClick; //Is the pick in fIDReadback a click?
+
+      bool fHoverPick; //Show information about the object under the mouse?
+      bool fHoverValid; //Is fHoverID up to date?
+      VisID fHoverID; //The object under the mouse
+
+      //A hover pick is only requested when something that could change fHoverID changed since the last one.  Otherwise, 
+      //a still mouse would read back a pixel every frame and keep frames coming.
+      bool NeedsHoverPick(const float x, const float y, const int width, const int height);
+      size_t SceneGeneration() const; //Sum of every Scene's Generation()
+      bool fHoverRequested; //Has a hover pick been requested for the state below?
+      float fHoverX; //Mouse position at the last hover pick
+      float fHoverY;
+      int fHoverWidth; //Viewport size at the last hover pick
+      int fHoverHeight;
+      glm::mat4 fHoverView; //View matrix at the last hover pick
+      glm::mat4 fHoverPersp; //Projection matrix at the last hover pick
+      size_t fHoverGeneration; //SceneGeneration() at the last hover pick
+
+      bool fCPUPicking; //Pick with each Scene's BVH instead of fIDBuffer?
+      float fPickRadius; //Radius in pixels within which CPU picking hits line segments and points
   };
 }
 #endif //End ifndef MYGL_VIEWER_H
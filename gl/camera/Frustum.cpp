@@ -0,0 +1,62 @@
+//File: Frustum.cpp
+//Brief: The volume a Camera can see.  Planes are extracted from the projection*view matrix following 
+//       Gribb and Hartmann, "Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix".
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//local includes
+#include "gl/camera/Frustum.h"
+
+//c++ includes
+#include <limits>
+#include <algorithm>
+
+namespace mygl
+{
+  Frustum::Frustum(const glm::mat4& projView): fProjView(projView)
+  {
+    //glm matrices are column-major, so row i is made from element i of each column
+    glm::vec4 rows[4];
+    for(size_t row = 0; row < 4; ++row) rows[row] = glm::vec4(projView[0][row], projView[1][row], projView[2][row], projView[3][row]);
+
+    for(size_t axis = 0; axis < 3; ++axis)
+    {
+      fPlanes[2*axis] = rows[3] + rows[axis];
+      fPlanes[2*axis+1] = rows[3] - rows[axis];
+    }
+  }
+
+  bool Frustum::Outside(const BoundingBox& box) const
+  {
+    if(box.fUnbounded) return false;
+    if(box.Empty()) return true;
+
+    for(const auto& plane: fPlanes)
+    {
+      //The corner of box farthest along this plane's normal
+      const glm::vec3 corner((plane.x > 0)?box.fMax.x:box.fMin.x, (plane.y > 0)?box.fMax.y:box.fMin.y, 
+                             (plane.z > 0)?box.fMax.z:box.fMin.z);
+      if(glm::dot(glm::vec3(plane), corner) + plane.w < 0) return true;
+    }
+    return false;
+  }
+
+  float Frustum::PixelSize(const BoundingBox& box, const int width, const int height) const
+  {
+    if(box.fUnbounded) return std::numeric_limits<float>::infinity();
+    if(box.Empty()) return 0;
+
+    glm::vec2 min(std::numeric_limits<float>::max()), max(std::numeric_limits<float>::lowest());
+    for(size_t corner = 0; corner < 8; ++corner)
+    {
+      const auto clip = fProjView*glm::vec4((corner & 1)?box.fMax.x:box.fMin.x, (corner & 2)?box.fMax.y:box.fMin.y, 
+                                            (corner & 4)?box.fMax.z:box.fMin.z, 1.);
+      if(clip.w <= std::numeric_limits<float>::epsilon()) return std::numeric_limits<float>::infinity();
+      const glm::vec2 ndc(clip.x/clip.w, clip.y/clip.w);
+      min = glm::min(min, ndc);
+      max = glm::max(max, ndc);
+    }
+
+    //NDC coordinates go from -1 to 1 across the viewport
+    return std::max((max.x - min.x)*width, (max.y - min.y)*height)/2.f;
+  }
+}
@@ -0,0 +1,35 @@
+//File: Frustum.h
+//Brief: The volume a Camera can see, calculated from its projection and view matrices.  Used to skip 
+//       Drawables that can't be seen and to estimate how big a Drawable will look on screen.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef MYGL_FRUSTUM_H
+#define MYGL_FRUSTUM_H
+
+//model includes
+#include "gl/model/BoundingBox.h"
+
+//glm includes
+#include <glm/glm.hpp>
+
+namespace mygl
+{
+  class Frustum
+  {
+    public:
+      Frustum(const glm::mat4& projView); //projView is projection*view
+
+      //True if box is completely outside of this Frustum.  Unbounded boxes are never outside.
+      bool Outside(const BoundingBox& box) const;
+
+      //Approximate number of pixels box covers along its longest screen axis in a width x height viewport.  
+      //Returns infinity for boxes that cross the camera plane.
+      float PixelSize(const BoundingBox& box, const int width, const int height) const;
+
+    private:
+      glm::mat4 fProjView;
+      glm::vec4 fPlanes[6]; //Inward-facing planes as (normal, distance)
+  };
+}
+
+#endif //MYGL_FRUSTUM_H
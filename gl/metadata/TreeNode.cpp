@@ -5,6 +5,7 @@
 //Local includes
 #include "Row.h"
 #include "gl/selection/VisID.h"
+#include "gl/model/BoundingBox.h"
 
 //c++ includes
 #include <list>
@@ -160,6 +161,7 @@ namespace ctrl
     HANDLE handle; //HANDLE for controlling drawing
     bool fVisible; //Whether this TreeNode is visible
     mygl::VisID fVisID; //Identifier associated with this row to make it selectable
+    mygl::BoundingBox fBounds; //Contains everything this TreeNode and all of its descendants draw
   };
 }
 
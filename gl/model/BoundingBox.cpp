@@ -0,0 +1,59 @@
+//File: BoundingBox.cpp
+//Brief: An axis-aligned box that contains everything a Drawable draws.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//local includes
+#include "gl/model/BoundingBox.h"
+
+//c++ includes
+#include <limits>
+
+namespace mygl
+{
+  BoundingBox::BoundingBox(): fMin(std::numeric_limits<float>::max()), fMax(std::numeric_limits<float>::lowest()), fUnbounded(false)
+  {
+  }
+
+  BoundingBox::BoundingBox(const glm::vec3& min, const glm::vec3& max): fMin(min), fMax(max), fUnbounded(false)
+  {
+  }
+
+  BoundingBox BoundingBox::Unbounded()
+  {
+    BoundingBox box;
+    box.fUnbounded = true;
+    return box;
+  }
+
+  void BoundingBox::Expand(const glm::vec3& point)
+  {
+    fMin = glm::min(fMin, point);
+    fMax = glm::max(fMax, point);
+  }
+
+  void BoundingBox::Expand(const BoundingBox& other)
+  {
+    if(other.fUnbounded) fUnbounded = true;
+    if(other.Empty()) return;
+    fMin = glm::min(fMin, other.fMin);
+    fMax = glm::max(fMax, other.fMax);
+  }
+
+  BoundingBox BoundingBox::Transform(const glm::mat4& mat) const
+  {
+    if(fUnbounded || Empty()) return *this;
+
+    BoundingBox result;
+    for(size_t corner = 0; corner < 8; ++corner)
+    {
+      const glm::vec4 point((corner & 1)?fMax.x:fMin.x, (corner & 2)?fMax.y:fMin.y, (corner & 4)?fMax.z:fMin.z, 1.);
+      result.Expand(glm::vec3(mat*point));
+    }
+    return result;
+  }
+
+  bool BoundingBox::Empty() const
+  {
+    return !fUnbounded && (fMin.x > fMax.x || fMin.y > fMax.y || fMin.z > fMax.z);
+  }
+}
@@ -0,0 +1,37 @@
+//File: BoundingBox.h
+//Brief: An axis-aligned box that contains everything a Drawable, or a whole tree of Drawables, draws.  Lets a 
+//       SceneController skip Drawables that the Camera can't see.  A BoundingBox can also be unbounded for 
+//       Drawables that don't know how big they are.  Those are never culled.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef MYGL_BOUNDINGBOX_H
+#define MYGL_BOUNDINGBOX_H
+
+//glm includes
+#include <glm/glm.hpp>
+
+namespace mygl
+{
+  struct BoundingBox
+  {
+    BoundingBox(); //Empty box that contains nothing
+    BoundingBox(const glm::vec3& min, const glm::vec3& max);
+
+    static BoundingBox Unbounded(); //Box that contains everything
+
+    //Grow this box to contain point or other
+    void Expand(const glm::vec3& point);
+    void Expand(const BoundingBox& other);
+
+    //Box in the coordinate system mat transforms to that contains this box
+    BoundingBox Transform(const glm::mat4& mat) const;
+
+    bool Empty() const;
+
+    glm::vec3 fMin;
+    glm::vec3 fMax;
+    bool fUnbounded; //If true, fMin and fMax are meaningless
+  };
+}
+
+#endif //MYGL_BOUNDINGBOX_H
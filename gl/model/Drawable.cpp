@@ -12,7 +12,8 @@
 
 namespace mygl
 {
-  Drawable::Drawable(const glm::mat4& model): fModel(model), fBorderWidth(0), fBorderColor(1., 0., 0., 1.)
+  Drawable::Drawable(const glm::mat4& model): fModel(model), fBorderWidth(0), fBorderColor(1., 0., 0., 1.), 
+                                           fBounds(BoundingBox::Unbounded())
   {
   }
 
@@ -29,6 +30,28 @@ namespace mygl
     DoDraw(prog);
   }
 
+  void Drawable::Primitives(const Vertex* /*vertices*/, const unsigned int* /*indices*/, PrimitiveSink& /*sink*/) const
+  {
+  }
+
+  void Drawable::StripPrimitives(const Vertex* vertices, const unsigned int* indices, const int* nVertices, 
+                                 const unsigned int* const* indexOffsets, const size_t nPolygons, PrimitiveSink& sink) const
+  {
+    for(size_t polygon = 0; polygon < nPolygons; ++polygon)
+    {
+      //indexOffsets are byte offsets into the index buffer disguised as pointers for glMultiDrawElements()
+      const auto first = indices + ((size_t)indexOffsets[polygon])/sizeof(unsigned int);
+
+      //Every other index is on the strip.  The rest are adjacency information for the geometry shader.
+      for(int vert = 0; vert + 4 < nVertices[polygon]; vert += 2)
+      {
+        sink.Triangle(glm::vec3(fModel*glm::vec4(vertices[first[vert]].position, 1.)), 
+                      glm::vec3(fModel*glm::vec4(vertices[first[vert+2]].position, 1.)), 
+                      glm::vec3(fModel*glm::vec4(vertices[first[vert+4]].position, 1.)));
+      }
+    }
+  }
+
   void Drawable::SetBorder(const float width, const glm::vec4& color)
   {
     fBorderWidth = width;
@@ -7,6 +7,9 @@
 #ifndef DRAW_DRAWABLE_H
 #define DRAW_DRAWABLE_H
 
+//local includes
+#include "gl/model/BoundingBox.h"
+
 //glm includes
 #include <glm/glm.hpp>
 
@@ -33,6 +36,9 @@ namespace mygl
 
       void SetBorder(const float width, const glm::vec4& color);
 
+      //Box in world coordinates that contains everything this Drawable draws.  Unbounded unless a derived class knows better.
+      const BoundingBox& GetBounds() const { return fBounds; }
+
       //Standard vertex structure for all Drawables
       struct Vertex
       {
@@ -40,15 +46,35 @@ namespace mygl
         glm::vec4 color;
       };
 
+      //Receives the shapes that a Drawable draws in world coordinates so that they can be picked without OpenGL
+      class PrimitiveSink
+      {
+        public:
+          virtual ~PrimitiveSink() = default;
+
+          virtual void Triangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) = 0;
+          virtual void Segment(const glm::vec3& a, const glm::vec3& b) = 0;
+          virtual void Point(const glm::vec3& point) = 0;
+      };
+
+      //Describe what this Drawable draws to sink.  vertices and indices are the data in the VAO::model this Drawable 
+      //was constructed with.  Drawables that can't be picked, like Grids, don't have to override this.
+      virtual void Primitives(const Vertex* vertices, const unsigned int* indices, PrimitiveSink& sink) const;
+
     protected:
       const glm::mat4 fModel; //Describes the origin of the coordinate system in which to place this Drawable
       float fBorderWidth; //Width of silhouette around object.  Setting to 0 presumably disables the border.
       glm::vec4 fBorderColor; //Color of border around object.  
       unsigned int fOffset; //Offset into vertex or index buffer where data for this Drawable can be found.  User needs to set this 
+      BoundingBox fBounds; //Box in world coordinates around this Drawable.  Derived classes should set this if they can.
 
       //All Drawables must implement this.
       virtual void DoDraw(mygl::ShaderProg& shader) = 0;
 
+      //Send the triangles in a set of GL_TRIANGLE_STRIP_ADJACENCY polygons like PolyMesh draws to sink
+      void StripPrimitives(const Vertex* vertices, const unsigned int* indices, const int* nVertices, 
+                           const unsigned int* const* indexOffsets, const size_t nPolygons, PrimitiveSink& sink) const;
+
     private: 
       //Add any other properties the drawing manager needs to know about here.  
       //TODO: How will different Drawables know to request different shader programs? 
@@ -5,14 +5,18 @@
 //glm includes
 #include <glm/glm.hpp>
 
+//c++ includes
+#include <cmath>
+
 //model includes
 #include "gl/model/Grid.h"
 
 namespace mygl
 {
   Grid::Grid(VAO::model& vao, const glm::mat4& model, const double width, const double horizSpace, const double height, const double vertSpace,
-             const glm::vec4& color, const float lineWidth): Drawable(model), fWidth(width), fHorizSpace(horizSpace), 
-                                                             fHeight(height), fVertSpace(vertSpace), fLineWidth(lineWidth)
+             const glm::vec4& color, const float lineWidth, const float fadeSpacing): Drawable(model), fWidth(width), 
+                                                             fHorizSpace(horizSpace), fHeight(height), fVertSpace(vertSpace), 
+                                                             fLineWidth(lineWidth), fFadeSpacing(fadeSpacing)
   {
     //Set up vertical line
     std::vector<Vertex> points;
@@ -49,26 +53,24 @@ namespace mygl
   void Grid::DoDraw(ShaderProg& shader)
   {
     shader.SetUniform("width", fLineWidth);
+    shader.SetUniform("fadeSpacing", fFadeSpacing);
+
+    //Lines go from one edge to the other.  If the spacing doesn't divide the grid evenly, 
+    //spread the lines out a little so that there is still a line on each edge.
+    const size_t nHoriz = std::lround(fHeight/fVertSpace)+1, nVert = std::lround(fWidth/fHorizSpace)+1;
 
     //Draw horizontal lines
-    for(double ypos = -fHeight/2.; ypos < fHeight/2.; ypos += fVertSpace) DrawHorizLine(shader, ypos);    
-    DrawHorizLine(shader, fHeight/2.);
+    DrawLines(shader, fOffset+4, glm::vec3(0.f, -fHeight/2., 0.f), glm::vec3(0.f, fHeight/(nHoriz-1), 0.f), nHoriz);
 
     //Draw vertical lines
-    for(double xpos = -fWidth/2.; xpos < fWidth/2.; xpos += fHorizSpace) DrawVertLine(shader, xpos);
-    DrawVertLine(shader, fWidth/2.);
-  }
-
-  void Grid::DrawVertLine(ShaderProg& shader, const double xpos)
-  {
-    shader.SetUniform("model", glm::translate(fModel, glm::vec3(xpos, 0.f, 0.f)));
-    glDrawArrays(GL_LINE_STRIP_ADJACENCY, fOffset, 4);
+    DrawLines(shader, fOffset, glm::vec3(-fWidth/2., 0.f, 0.f), glm::vec3(fWidth/(nVert-1), 0.f, 0.f), nVert);
   }
 
-  void Grid::DrawHorizLine(ShaderProg& shader, const double ypos)
+  void Grid::DrawLines(ShaderProg& shader, const unsigned int offset, const glm::vec3& start, const glm::vec3& step, const size_t nLines)
   {
-    shader.SetUniform("model", glm::translate(fModel, glm::vec3(0.f, ypos, 0.f)));
-    glDrawArrays(GL_LINE_STRIP_ADJACENCY, fOffset+4, 4);
+    shader.SetUniform("lineStart", start);
+    shader.SetUniform("lineStep", step);
+    glDrawArraysInstanced(GL_LINE_STRIP_ADJACENCY, offset, 4, nLines);
   }
 
   Grid::~Grid()
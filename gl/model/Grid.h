@@ -1,7 +1,9 @@
 //File: Grid.h
 //Brief: A Grid is a Drawable that renders a grid of lines in the x-y plane given the grid's horizontal and vertical 
 //       size.  A Grid is rendered by drawing a line between the same two points shifted by a specified spacing in the 
-//       horizontal and vertical directions.  
+//       horizontal and vertical directions.  Each direction is drawn with one instanced draw call, so use a Grid with 
+//       a vertex shader like grid.vert that shifts each instance by its gl_InstanceID.  Lines fade out as they get 
+//       closer together on screen than a fade spacing.  
 //Author: Andrew Olivier aolivier@ur.rochester.edu
 
 //model includes
@@ -18,7 +20,7 @@ namespace mygl
   {
     public:
       Grid(VAO::model& vao, const glm::mat4& model, const double width, const double horizSpace, const double height, const double vertSpace, 
-           const glm::vec4& color, const float lineWidth);
+           const glm::vec4& color, const float lineWidth, const float fadeSpacing);
       virtual ~Grid();
 
       virtual void DoDraw(mygl::ShaderProg& shader);
@@ -29,10 +31,11 @@ namespace mygl
       const double fHeight; //Height of the grid
       const double fVertSpace; //Spacing between lines in the vertical (y) direction
 
-      void DrawVertLine(mygl::ShaderProg& prog, const double ypos); //Draw a vertical line at a point pos
-      void DrawHorizLine(mygl::ShaderProg& prog, const double xpos); //Draw a horizontal line at a point pos
+      //Draw nLines copies of the line at offset in the VAO, each shifted by step from the last starting at start
+      void DrawLines(mygl::ShaderProg& prog, const unsigned int offset, const glm::vec3& start, const glm::vec3& step, const size_t nLines);
 
       const float fLineWidth; //The width of lines to draw in NDC coordinates
+      const float fFadeSpacing; //Lines closer together than this in NDC coordinates start to fade out
   };
 }
 
@@ -0,0 +1,190 @@
+//File: MeshBuilder.cpp
+//Brief: Builds GL_TRIANGLE_STRIP_ADJACENCY indices from ROOT's kRaw tesselation of a TGeoShape.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//local includes
+#include "gl/model/MeshBuilder.h"
+
+//ROOT includes
+#include "TGeoShape.h"
+#include "TBuffer3D.h"
+
+//c++ includes
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+
+namespace mygl
+{
+  void MeshBuilder::Build(TGeoShape* shape)
+  {
+    if(shape == nullptr) 
+    {
+      std::cerr << "Volume is invalid!  Trouble is coming...\n"; //TODO: Throw exception
+      fPoints.clear();
+      fIndices.clear();
+      fPolygonSizes.clear();
+      return;
+    }
+
+    const auto& buf = shape->GetBuffer3D(TBuffer3D::kRaw | TBuffer3D::kRawSizes, true);
+    Build(buf.fPnts, buf.NbPnts(), buf.fSegs, buf.fPols, buf.NbPols());
+  }
+
+  void MeshBuilder::Build(const double* points, const size_t nPoints, const int* segs, const int* pols, const size_t nPols)
+  {
+    fPoints.clear();
+    fIndices.clear();
+    fPolygonSizes.clear();
+    fWound.clear();
+    fWoundSizes.clear();
+
+    fPoints.reserve(nPoints);
+    glm::vec3 shapeCenter(0., 0., 0.);
+    for(size_t pt = 0; pt < nPoints; ++pt)
+    {
+      const glm::vec3 point(points[3*pt], points[3*pt+1], points[3*pt+2]);
+      fPoints.push_back(point);
+      shapeCenter += point;
+    }
+    shapeCenter *= 1./nPoints;
+
+    //Wind the vertices of each polygon around its center.  ROOT only ever draws convex polygons, so each polygon 
+    //can be drawn as a triangle strip that alternates sides of the polygon.  
+    size_t polPos = 0; //Position in the array of polygon "components"
+    for(size_t pol = 0; pol < nPols; ++pol)
+    {
+      const size_t nSegs = pols[polPos+1]; //The second "component" of each polygon is the number of segments it contains
+      const auto first = fWound.size();
+
+      //Each vertex appears in two segments.  Sorting and removing duplicates is cheaper than a std::set for a 
+      //few vertices.
+      for(size_t seg = 0; seg < nSegs; ++seg)
+      {
+        const auto segPos = pols[polPos+2+seg];
+        fWound.push_back(segs[1+segPos*3]);
+        fWound.push_back(segs[2+segPos*3]);
+      }
+      polPos += nSegs+2;
+
+      std::sort(fWound.begin()+first, fWound.end());
+      fWound.erase(std::unique(fWound.begin()+first, fWound.end()), fWound.end());
+      const size_t nVertices = fWound.size() - first;
+      if(nVertices < 3) //A polygon with less than 3 unique vertices has no area to draw
+      {
+        fWound.resize(first);
+        continue;
+      }
+
+      glm::vec3 center(0., 0., 0.);
+      for(auto vert = fWound.begin()+first; vert != fWound.end(); ++vert) center += fPoints[*vert];
+      center *= 1./nSegs;
+      const auto out = glm::normalize(center-shapeCenter);
+
+      //Calculate the angle of each vertex from the first vertex once instead of in a sort comparator
+      const auto prevDir = glm::normalize(fPoints[fWound[first]]-center);
+      fAngles.clear();
+      for(auto vert = fWound.begin()+first; vert != fWound.end(); ++vert)
+      {
+        const auto dir = glm::normalize(fPoints[*vert]-center);
+        fAngles.emplace_back(std::atan2(glm::length(glm::cross(prevDir, dir)), glm::dot(dir, prevDir)), *vert);
+      }
+      std::sort(fAngles.begin(), fAngles.end());
+      for(size_t vert = 0; vert < nVertices; ++vert) fWound[first+vert] = fAngles[vert].second;
+
+      //Make sure that pairs of vertices alternate sides of the polygon in the winding order 
+      for(size_t vert = first+1; vert+1 < fWound.size(); vert += 2)
+      {
+        const auto dir = glm::normalize(fPoints[fWound[vert]]-center);
+        if(glm::dot(glm::cross(prevDir, dir), out) < 0) std::swap(fWound[vert], fWound[vert+1]);
+      }
+
+      fWoundSizes.push_back(nVertices);
+    }
+
+    //Map each edge on the border of a polygon's triangle strip to the vertex across from it.  Every polygon adds 
+    //exactly as many edges as it has vertices.  
+    fEdges.Reset(fWound.size());
+    size_t first = 0;
+    for(const auto nVertices: fWoundSizes)
+    {
+      const auto wound = fWound.data() + first;
+      fEdges.Set(wound[0], wound[1], wound[2]); //Second edge of the first triangle
+      for(size_t vert = 0; vert < nVertices-2; ++vert) fEdges.Set(wound[vert+2], wound[vert], wound[vert+1]);
+      fEdges.Set(wound[nVertices-2], wound[nVertices-1], wound[nVertices-3]); //Second edge of the last triangle
+      first += nVertices;
+    }
+
+    //Emit the triangle strip with adjacency for each polygon.  Each polygon needs 2 indices per vertex.
+    fIndices.reserve(2*fWound.size());
+    fPolygonSizes.reserve(fWoundSizes.size());
+    first = 0;
+    for(const auto nVertices: fWoundSizes)
+    {
+      const auto wound = fWound.data() + first;
+      fIndices.push_back(wound[0]);
+      fIndices.push_back(fEdges.Get(wound[1], wound[0]));
+      fIndices.push_back(wound[1]);
+      fIndices.push_back(fEdges.Get(wound[0], wound[2]));
+      fIndices.push_back(wound[2]);
+      for(size_t vert = 1; vert+2 < nVertices; ++vert)
+      {
+        fIndices.push_back(fEdges.Get(wound[vert], wound[vert+2]));
+        fIndices.push_back(wound[vert+2]);
+      }
+      fIndices.push_back(fEdges.Get(wound[nVertices-1], wound[nVertices-2]));
+
+      fPolygonSizes.push_back(2*nVertices);
+      first += nVertices;
+    }
+  }
+
+  namespace
+  {
+    constexpr uint64_t emptyKey = ~uint64_t(0); //No edge can have this key because no vertex index is ~0u
+
+    uint64_t edgeKey(const unsigned int from, const unsigned int to)
+    {
+      return (uint64_t(from) << 32) | to;
+    }
+  }
+
+  void MeshBuilder::EdgeMap::Reset(const size_t nEdges)
+  {
+    //Keep the load factor at or below 1/2
+    size_t nSlots = 16;
+    while(nSlots < 2*nEdges) nSlots *= 2;
+    fKeys.assign(nSlots, emptyKey);
+    fValues.resize(nSlots);
+    fMask = nSlots-1;
+  }
+
+  size_t MeshBuilder::EdgeMap::Slot(const uint64_t key) const
+  {
+    //splitmix64 finalizer: mixes both vertex indices into every bit of the slot
+    uint64_t hash = key;
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+    hash ^= hash >> 31;
+    return hash & fMask;
+  }
+
+  void MeshBuilder::EdgeMap::Set(const unsigned int from, const unsigned int to, const unsigned int third)
+  {
+    const auto key = edgeKey(from, to);
+    auto slot = Slot(key);
+    while(fKeys[slot] != emptyKey && fKeys[slot] != key) slot = (slot+1) & fMask;
+    fKeys[slot] = key;
+    fValues[slot] = third;
+  }
+
+  unsigned int MeshBuilder::EdgeMap::Get(const unsigned int from, const unsigned int to) const
+  {
+    const auto key = edgeKey(from, to);
+    for(auto slot = Slot(key); fKeys[slot] != emptyKey; slot = (slot+1) & fMask)
+    {
+      if(fKeys[slot] == key) return fValues[slot];
+    }
+    return 0; //Same as the old std::unordered_map::operator[] for an edge on only one polygon
+  }
+}
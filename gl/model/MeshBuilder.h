@@ -0,0 +1,76 @@
+//File: MeshBuilder.h
+//Brief: A MeshBuilder turns ROOT's kRaw tesselation of a TGeoShape into the GL_TRIANGLE_STRIP_ADJACENCY indices 
+//       that PolyMesh and MeshInstance draw.  Each ROOT polygon becomes one triangle strip whose vertices are 
+//       wound around the polygon's center.  The adjacent vertex for each edge of a strip is the vertex across 
+//       that edge in the neighboring polygon, so triangleBorder.geom can find silhouette edges.  
+//
+//       A MeshBuilder runs in time linear in the size of the tesselation (apart from sorting the handful of 
+//       vertices in each polygon).  Everything is stored in flat arrays that are reused between polygons and 
+//       between calls to Build(), so reuse one MeshBuilder to tesselate many shapes.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef MYGL_MESHBUILDER_H
+#define MYGL_MESHBUILDER_H
+
+//glm includes
+#include <glm/glm.hpp>
+
+//c++ includes
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+class TGeoShape;
+
+namespace mygl
+{
+  class MeshBuilder
+  {
+    public:
+      MeshBuilder() = default;
+      virtual ~MeshBuilder() = default;
+
+      //Build the mesh for shape from ROOT's kRaw tesselation
+      void Build(TGeoShape* shape);
+
+      //Build the mesh from arrays in the same format as TBuffer3D's kRaw section.  See 
+      //https://root.cern.ch/doc/master/viewer3DLocal_8C_source.html for a description of that format.
+      void Build(const double* points, const size_t nPoints, const int* segs, const int* pols, const size_t nPols);
+
+      //Results of the last call to Build()
+      const std::vector<glm::vec3>& Points() const { return fPoints; }
+      const std::vector<unsigned int>& Indices() const { return fIndices; } //Indices for each polygon, one after another
+      const std::vector<int>& PolygonSizes() const { return fPolygonSizes; } //Number of indices for each polygon
+
+    private:
+      //Maps a directed edge between two vertices to the vertex that completes a triangle with it.  Open 
+      //addressing with linear probing in flat arrays.  
+      class EdgeMap
+      {
+        public:
+          void Reset(const size_t nEdges); //Clear and make room for at least nEdges edges
+          void Set(const unsigned int from, const unsigned int to, const unsigned int third);
+          unsigned int Get(const unsigned int from, const unsigned int to) const; //0 if there is no such edge 
+
+        private:
+          std::vector<uint64_t> fKeys; 
+          std::vector<unsigned int> fValues;
+          size_t fMask; //Number of slots minus 1.  Number of slots is always a power of 2.
+
+          size_t Slot(const uint64_t key) const;
+      };
+
+      //Results
+      std::vector<glm::vec3> fPoints;
+      std::vector<unsigned int> fIndices;
+      std::vector<int> fPolygonSizes;
+
+      //Scratch space
+      std::vector<unsigned int> fWound; //Unique vertices of each polygon in winding order, polygon after polygon
+      std::vector<size_t> fWoundSizes; //Number of vertices of each polygon in fWound
+      std::vector<std::pair<float, unsigned int>> fAngles; //Angle of each vertex of the current polygon around its center
+      EdgeMap fEdges;
+  };
+}
+
+#endif //MYGL_MESHBUILDER_H
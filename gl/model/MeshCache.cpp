@@ -0,0 +1,94 @@
+//File: MeshCache.cpp
+//Brief: Tesselates each unique TGeoShape once and shares the result between all of the MeshInstances that draw it.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//local includes
+#include "gl/model/MeshCache.h"
+
+//glm includes
+#include <glm/glm.hpp>
+
+namespace
+{
+  //Storage for a Tessellation from ROOT
+  struct Owned
+  {
+    std::vector<mygl::Drawable::Vertex> fVertices;
+    std::vector<unsigned int> fIndices;
+    std::vector<int> fPolygonSizes;
+  };
+}
+
+namespace mygl
+{
+  std::shared_ptr<const MeshCache::Mesh> MeshCache::Get(VAO::model& vao, TGeoShape* shape)
+  {
+    return Get(vao, Find(shape));
+  }
+
+  size_t MeshCache::Find(TGeoShape* shape)
+  {
+    const auto found = fShapes.find(shape);
+    if(found != fShapes.end()) return found->second;
+
+    fBuilder.Build(shape);
+
+    //Vertices are white so that MeshInstances can give each placement its own color with a uniform
+    auto data = std::make_shared<Owned>();
+    data->fVertices.reserve(fBuilder.Points().size());
+    for(const auto& point: fBuilder.Points())
+    {
+      Drawable::Vertex vert;
+      vert.position = point;
+      vert.color = glm::vec4(1., 1., 1., 1.);
+      data->fVertices.push_back(vert);
+    }
+    data->fIndices = fBuilder.Indices();
+    data->fPolygonSizes = fBuilder.PolygonSizes();
+
+    Tessellation tess;
+    tess.fVertices = data->fVertices.data();
+    tess.fNVertices = data->fVertices.size();
+    tess.fIndices = data->fIndices.data();
+    tess.fNIndices = data->fIndices.size();
+    tess.fPolygonSizes = data->fPolygonSizes.data();
+    tess.fNPolygons = data->fPolygonSizes.size();
+
+    const auto index = Add(tess, data);
+    fShapes[shape] = index;
+    return index;
+  }
+
+  size_t MeshCache::Add(const Tessellation& tess, std::shared_ptr<const void> owner)
+  {
+    fEntries.push_back(Entry{tess, owner, nullptr});
+    return fEntries.size()-1;
+  }
+
+  std::shared_ptr<const MeshCache::Mesh> MeshCache::Get(VAO::model& vao, const size_t index)
+  {
+    auto& entry = fEntries.at(index);
+    if(entry.fMesh) return entry.fMesh;
+
+    //Same index layout as PolyMesh::Init()
+    const auto& tess = entry.fTess;
+    auto mesh = std::make_shared<Mesh>();
+    mesh->fNVertices.assign(tess.fPolygonSizes, tess.fPolygonSizes + tess.fNPolygons);
+    mesh->fIndexOffsets.reserve(tess.fNPolygons+1);
+    mesh->fIndexOffsets.push_back(nullptr);
+    GLuint indexPos = 0;
+    for(const auto size: mesh->fNVertices)
+    {
+      indexPos += size;
+      mesh->fIndexOffsets.push_back((GLuint*)(indexPos*sizeof(GLuint)));
+    }
+
+    for(size_t vert = 0; vert < tess.fNVertices; ++vert) mesh->fBounds.Expand(tess.fVertices[vert].position);
+
+    const auto offset = vao.Register(tess.fVertices, tess.fNVertices, tess.fIndices, tess.fNIndices);
+    for(auto& indexOffset: mesh->fIndexOffsets) indexOffset += offset;
+
+    entry.fMesh = mesh;
+    return mesh;
+  }
+}
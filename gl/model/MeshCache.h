@@ -0,0 +1,89 @@
+//File: MeshCache.h
+//Brief: A MeshCache tesselates each TGeoShape it is asked about only once.  Detector geometries often place the 
+//       same TGeoVolume thousands of times, like the cubes of a 3D scintillator tracker.  Every placement shares 
+//       the same TGeoShape, so its vertices and indices only need to be Register()ed with a VAO::model once.  
+//       MeshInstances then draw the shared Mesh with their own model matrix and color.  A MeshCache only knows 
+//       about one VAO::model, so use a new MeshCache for each SceneModel.  
+//
+//       A MeshCache can also be given Tessellations that were made somewhere else, like a geometry cache file, 
+//       so that ROOT's tesselation can be skipped entirely.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef MYGL_MESHCACHE_H
+#define MYGL_MESHCACHE_H
+
+//model includes
+#include "gl/objects/VAO.h"
+#include "gl/model/MeshBuilder.h"
+#include "gl/model/BoundingBox.h"
+
+//glad includes
+#include "glad/include/glad/glad.h" //For GLuint
+
+//c++ includes
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+class TGeoShape;
+
+namespace mygl
+{
+  class MeshCache
+  {
+    public:
+      //Everything needed to draw a shape that has already been Register()ed with a VAO::model.  Same format 
+      //that PolyMesh uses.
+      struct Mesh
+      {
+        std::vector<int> fNVertices; //Number of vertices in each polygon
+        std::vector<GLuint*> fIndexOffsets; //Pointer to the beginning of the indices for each polygon
+        BoundingBox fBounds; //Box around all vertices in the shape's own coordinate system
+      };
+
+      //Vertices and indices for one shape before they are Register()ed.  Does not own its data.  
+      struct Tessellation
+      {
+        const Drawable::Vertex* fVertices; 
+        size_t fNVertices;
+        const unsigned int* fIndices; //Indices of all polygons, one after another, relative to fVertices
+        size_t fNIndices;
+        const int* fPolygonSizes; //Number of indices in each polygon
+        size_t fNPolygons;
+      };
+
+      MeshCache() = default;
+      virtual ~MeshCache() = default;
+
+      //Get the Mesh for shape.  The first time a shape is requested, tesselate it and Register() it with vao.  
+      //vao must be the same VAO::model every time.  Meshes stay valid even after this MeshCache is destroyed.
+      std::shared_ptr<const Mesh> Get(VAO::model& vao, TGeoShape* shape);
+
+      //Get the Mesh at index, Register()ing it with vao if this is the first time it was requested.
+      std::shared_ptr<const Mesh> Get(VAO::model& vao, const size_t index);
+
+      //Index of shape's Tessellation.  Tesselates shape if this MeshCache hasn't seen it yet.
+      size_t Find(TGeoShape* shape);
+
+      //Add a Tessellation that was made somewhere else.  owner keeps the memory tess points to alive for as long 
+      //as this MeshCache might need it.  Returns the index of tess.
+      size_t Add(const Tessellation& tess, std::shared_ptr<const void> owner);
+
+      size_t size() const { return fEntries.size(); } //Number of unique shapes known so far
+      const Tessellation& operator [](const size_t index) const { return fEntries[index].fTess; }
+
+    private:
+      struct Entry
+      {
+        Tessellation fTess; //Data to Register() 
+        std::shared_ptr<const void> fOwner; //Keeps fTess valid
+        std::shared_ptr<const Mesh> fMesh; //nullptr until fTess has been Register()ed
+      };
+
+      std::vector<Entry> fEntries; //One Entry for each unique mesh
+      std::unordered_map<const TGeoShape*, size_t> fShapes; //Index in fEntries of each TGeoShape tesselated
+      MeshBuilder fBuilder; //Reused for every shape to avoid reallocating its scratch space
+  };
+}
+
+#endif //MYGL_MESHCACHE_H
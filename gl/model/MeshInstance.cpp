@@ -0,0 +1,41 @@
+//File: MeshInstance.cpp
+//Brief: Draws a mesh shared with other MeshInstances using its own model matrix and color.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//local includes
+#include "gl/model/MeshInstance.h"
+
+namespace mygl
+{
+  MeshInstance::MeshInstance(VAO::model& /*vao*/, const glm::mat4& model, std::shared_ptr<const MeshCache::Mesh> mesh, 
+                             const glm::vec4& color): Drawable(model), fMesh(mesh), fColor(color)
+  {
+    fBounds = fMesh->fBounds.Transform(fModel);
+  }
+
+  MeshInstance::MeshInstance(VAO::model& vao, const glm::mat4& model, MeshCache* cache, TGeoShape* shape, 
+                             const glm::vec4& color): MeshInstance(vao, model, cache->Get(vao, shape), color)
+  {
+  }
+
+  MeshInstance::MeshInstance(VAO::model& vao, const glm::mat4& model, MeshCache* cache, const size_t index, 
+                             const glm::vec4& color): MeshInstance(vao, model, cache->Get(vao, index), color)
+  {
+  }
+
+  MeshInstance::~MeshInstance()
+  {
+  }
+
+  void MeshInstance::Primitives(const Vertex* vertices, const unsigned int* indices, PrimitiveSink& sink) const
+  {
+    StripPrimitives(vertices, indices, fMesh->fNVertices.data(), fMesh->fIndexOffsets.data(), fMesh->fNVertices.size(), sink);
+  }
+
+  void MeshInstance::DoDraw(ShaderProg& shader)
+  {
+    shader.SetUniform("instanceColor", fColor);
+    glMultiDrawElements(GL_TRIANGLE_STRIP_ADJACENCY, (GLsizei*)(&fMesh->fNVertices[0]), GL_UNSIGNED_INT, 
+                        (const GLvoid**)(&fMesh->fIndexOffsets[0]), fMesh->fNVertices.size());
+  }
+}
@@ -0,0 +1,49 @@
+//File: MeshInstance.h
+//Brief: A MeshInstance draws a mesh shared with other MeshInstances, like the tesselation of a TGeoShape from a MeshCache, 
+//       with its own model matrix and color.  It behaves like a PolyMesh, but it does not add any vertices to 
+//       its VAO::model.  The color is passed to the shader in the "instanceColor" uniform, so use MeshInstances with a 
+//       vertex shader like meshInstance.vert.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef MYGL_MESHINSTANCE_H
+#define MYGL_MESHINSTANCE_H
+
+//model includes
+#include "gl/objects/VAO.h"
+
+//gl includes
+#include "gl/model/Drawable.h"
+#include "gl/model/MeshCache.h"
+#include "gl/objects/ShaderProg.h"
+
+//glm includes
+#include <glm/glm.hpp>
+
+//c++ includes
+#include <memory>
+
+class TGeoShape;
+
+namespace mygl
+{
+  class MeshInstance: public Drawable
+  {
+    public:
+      MeshInstance(VAO::model& vao, const glm::mat4& model, std::shared_ptr<const MeshCache::Mesh> mesh, const glm::vec4& color);
+      //Look up shape in cache.  Takes cache by pointer because SceneModel::view::emplace() copies its arguments.
+      MeshInstance(VAO::model& vao, const glm::mat4& model, MeshCache* cache, TGeoShape* shape, const glm::vec4& color);
+      //Draw the Mesh at index in cache
+      MeshInstance(VAO::model& vao, const glm::mat4& model, MeshCache* cache, const size_t index, const glm::vec4& color);
+
+      virtual ~MeshInstance();
+
+      void DoDraw(ShaderProg& shader);
+      void Primitives(const Vertex* vertices, const unsigned int* indices, PrimitiveSink& sink) const override;
+
+    protected:
+      std::shared_ptr<const MeshCache::Mesh> fMesh; //Vertices and indices shared with other MeshInstances
+      glm::vec4 fColor; //Color of this instance.  Multiplies the color of the shared vertices.
+  };
+}
+
+#endif //MYGL_MESHINSTANCE_H
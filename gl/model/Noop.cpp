@@ -9,6 +9,7 @@ namespace mygl
 {
   Noop::Noop(VAO::model& /*vao*/): Drawable(glm::mat4())
   {
+    fBounds = BoundingBox(); //Draws nothing, so it should never stop its children from being culled
   }
 
   void Noop::DoDraw(ShaderProg& /*shader*/)
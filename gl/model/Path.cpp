@@ -39,6 +39,15 @@ namespace mygl
     glDrawArrays(GL_LINE_STRIP_ADJACENCY, fOffset, fNVertices);
   }
 
+  void Path::Primitives(const Vertex* vertices, const unsigned int* /*indices*/, PrimitiveSink& sink) const
+  {
+    //Skip the extra vertices on each end that are only there for adjacency information
+    for(GLuint vert = fOffset+1; vert+2 < fOffset+fNVertices; ++vert)
+    {
+      sink.Segment(glm::vec3(fModel*glm::vec4(vertices[vert].position, 1.)), glm::vec3(fModel*glm::vec4(vertices[vert+1].position, 1.)));
+    }
+  }
+
   void Path::Init(VAO::model& vao, std::vector<Vertex> points)
   {
     //Add one extra vertex on each end of points to provide adjacency information
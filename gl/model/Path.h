@@ -28,6 +28,7 @@ namespace mygl
       virtual ~Path();
 
       virtual void DoDraw(mygl::ShaderProg& shader);
+      virtual void Primitives(const Vertex* vertices, const unsigned int* indices, PrimitiveSink& sink) const override;
 
     private:
       const GLuint fNVertices; //Number of vertices in this path
@@ -31,6 +31,11 @@ namespace mygl
     glDrawArrays(GL_POINTS, fOffset, fNVertices);
   }
 
+  void Point::Primitives(const Vertex* vertices, const unsigned int* /*indices*/, PrimitiveSink& sink) const
+  {
+    sink.Point(glm::vec3(fModel*glm::vec4(vertices[fOffset].position, 1.)));
+  }
+
   Point::~Point()
   {
   }
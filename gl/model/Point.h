@@ -25,6 +25,7 @@ namespace mygl
       virtual ~Point();
 
       virtual void DoDraw(mygl::ShaderProg& shader);
+      virtual void Primitives(const Vertex* vertices, const unsigned int* indices, PrimitiveSink& sink) const override;
 
     private:
       const GLuint fNVertices; //Number of vertices in this path
@@ -44,6 +44,7 @@ namespace mygl
       virtual ~PolyMesh(); //To allow derived classes to override
       
       void DoDraw(ShaderProg& shader);
+      void Primitives(const Vertex* vertices, const unsigned int* indices, PrimitiveSink& sink) const override;
 
     protected:
       std::vector<int> fNVertices; //Number of vertices in each polygon.  Using int instead of size_t for compatibility with opengl
@@ -56,10 +57,12 @@ namespace mygl
       void Init(VAO::model& vao, const CONTAINER& vertices, const INDICES& indices, const glm::vec4& color)
       {
         std::vector<Vertex> vertexData;
+        BoundingBox local;
         for(const auto& vertex: vertices)
         {
           Vertex vert;
           vert.position = vertex;
+          local.Expand(vert.position);
           vert.color = color;
           vertexData.push_back(vert);
         }
@@ -77,6 +80,7 @@ namespace mygl
 
         fOffset = vao.Register(vertexData, flatIndices); 
         for(auto& offset: fIndexOffsets) offset += fOffset;
+        fBounds = local.Transform(fModel);
       }
   };
 }
@@ -8,9 +8,15 @@
 //local includes
 #include "gl/objects/Framebuffer.h"
 
+//util includes
+#include "util/GenException.h"
+
 namespace mygl
 {
-  Framebuffer::Framebuffer()
+  Framebuffer::Framebuffer(const GLenum internalFormat, const GLenum format, const GLenum type): fColorID(0), fDepthID(0), 
+                                                                                                 fInternalFormat(internalFormat),
+                                                                                                 fFormat(format), fType(type), 
+                                                                                                 fWidth(0), fHeight(0)
   {
     glGenFramebuffers(1, &fBufferID);
   }
@@ -18,6 +24,8 @@ namespace mygl
   Framebuffer::~Framebuffer()
   {
     glDeleteFramebuffers(1, &fBufferID);
+    if(fColorID != 0) glDeleteTextures(1, &fColorID);
+    if(fDepthID != 0) glDeleteRenderbuffers(1, &fDepthID);
   }
 
   void Framebuffer::Use()
@@ -29,4 +37,38 @@ namespace mygl
   {
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
   }
+
+  bool Framebuffer::Resize(const int width, const int height)
+  {
+    if(width == fWidth && height == fHeight) return false;
+
+    if(fColorID == 0) glGenTextures(1, &fColorID);
+    glBindTexture(GL_TEXTURE_2D, fColorID);
+    glTexImage2D(GL_TEXTURE_2D, 0, fInternalFormat, width, height, 0, fFormat, fType, nullptr);
+    //Integer textures can't be filtered, and nothing should be interpolated between pixels anyway
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if(fDepthID == 0) glGenRenderbuffers(1, &fDepthID);
+    glBindRenderbuffer(GL_RENDERBUFFER, fDepthID);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    GLint previous = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous);
+    Use();
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, fColorID, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, fDepthID);
+    const auto status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, previous);
+
+    if(status != GL_FRAMEBUFFER_COMPLETE) throw util::GenException("Incomplete Framebuffer") << "Framebuffer with size " << width << "x" 
+                                                                                             << height << " is not complete.  Status is " 
+                                                                                             << status << ".\n";
+
+    fWidth = width;
+    fHeight = height;
+    return true;
+  }
 } 
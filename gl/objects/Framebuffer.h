@@ -1,23 +1,44 @@
 //File: Framebuffer.h
-//Brief: Simple parameters for an OpenGL framebuffer object.  Might need to get more complicated in the future.
+//Brief: Simple parameters for an OpenGL framebuffer object.  A Framebuffer has one color texture and a depth 
+//       renderbuffer so that Scenes can be rendered somewhere other than the screen.  Call Resize() before drawing 
+//       to allocate them.  
 //Author: Andrew Olivier aolivier@ur.rochester.edu
 
 #ifndef MYGL_FRAMEBUFFER_H
 #define MYGL_FRAMEBUFFER_H
 
+//glad includes
+#include "glad/include/glad/glad.h" //For GLenum
+
 namespace mygl
 {
   class Framebuffer
   {
     public:
-      Framebuffer();
+      //internalFormat, format, and type describe the color texture like the arguments to glTexImage2D()
+      Framebuffer(const GLenum internalFormat = GL_RGBA8, const GLenum format = GL_RGBA, const GLenum type = GL_UNSIGNED_BYTE);
       virtual ~Framebuffer();
 
       void Use(); //Make this the current Framebuffer
       static void Default(); //Make the default framebuffer the current framebuffer
+
+      //(Re)allocate attachments if width or height changed.  Returns true if anything was reallocated.
+      bool Resize(const int width, const int height);
+
+      int Width() const { return fWidth; }
+      int Height() const { return fHeight; }
      
     private:
       unsigned int fBufferID; //The OpenGL ID for this object's framebuffer object
+      unsigned int fColorID; //The OpenGL ID for the color texture
+      unsigned int fDepthID; //The OpenGL ID for the depth renderbuffer
+
+      GLenum fInternalFormat; //Format of each pixel in the color texture
+      GLenum fFormat; //Format of pixel data passed to OpenGL
+      GLenum fType; //Type of pixel data passed to OpenGL
+
+      int fWidth; //Width of attachments in pixels
+      int fHeight; //Height of attachments in pixels
   };
 }
 
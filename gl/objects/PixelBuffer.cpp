@@ -0,0 +1,66 @@
+//File: PixelBuffer.cpp
+//Brief: Reads pixels through a pixel buffer object so that the CPU doesn't have to wait for the GPU.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//local includes
+#include "gl/objects/PixelBuffer.h"
+
+//c++ includes
+#include <cstring>
+
+namespace mygl
+{
+  PixelBuffer::PixelBuffer(): fFence(nullptr), fBytes(0), fCapacity(0)
+  {
+    glGenBuffers(1, &fBufferID);
+  }
+
+  PixelBuffer::~PixelBuffer()
+  {
+    if(fFence) glDeleteSync(fFence);
+    glDeleteBuffers(1, &fBufferID);
+  }
+
+  void PixelBuffer::Read(const int x, const int y, const int width, const int height, const GLenum format, const GLenum type, 
+                         const size_t bytes)
+  {
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, fBufferID);
+    if(bytes > fCapacity)
+    {
+      glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+      fCapacity = bytes;
+    }
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(x, y, width, height, format, type, nullptr); //Writes to fBufferID instead of client memory
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if(fFence) glDeleteSync(fFence);
+    fFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    fBytes = bytes;
+    glFlush(); //Make sure the fence actually gets to the GPU so that Ready() eventually returns true
+  }
+
+  bool PixelBuffer::Ready()
+  {
+    if(!fFence) return false;
+    const auto status = glClientWaitSync(fFence, 0, 0);
+    return (status == GL_ALREADY_SIGNALED) || (status == GL_CONDITION_SATISFIED);
+  }
+
+  bool PixelBuffer::Map(void* dest)
+  {
+    if(!fFence) return false;
+    glClientWaitSync(fFence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+    glDeleteSync(fFence);
+    fFence = nullptr;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, fBufferID);
+    const void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, fBytes, GL_MAP_READ_BIT);
+    if(pixels) std::memcpy(dest, pixels, fBytes);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    return pixels != nullptr;
+  }
+}
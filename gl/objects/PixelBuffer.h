@@ -0,0 +1,43 @@
+//File: PixelBuffer.h
+//Brief: A PixelBuffer reads pixels from the current Framebuffer without waiting for the GPU to finish drawing.  Read() 
+//       starts copying pixels into an OpenGL pixel buffer object and returns immediately.  Poll Ready() each frame, then 
+//       Map() the pixels once they have arrived.  Only one Read() can be in flight at a time.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef MYGL_PIXELBUFFER_H
+#define MYGL_PIXELBUFFER_H
+
+//glad includes
+#include "glad/include/glad/glad.h"
+
+//c++ includes
+#include <cstddef>
+
+namespace mygl
+{
+  class PixelBuffer
+  {
+    public:
+      PixelBuffer();
+      virtual ~PixelBuffer();
+
+      //Start copying a width x height block of pixels starting at (x, y) in the current read Framebuffer.  format and type 
+      //are passed to glReadPixels().  Replaces any Read() that hasn't been Map()ped yet.
+      void Read(const int x, const int y, const int width, const int height, const GLenum format, const GLenum type, const size_t bytes);
+
+      bool Pending() const { return fFence != nullptr; } //Is there a Read() that hasn't been Map()ped yet?
+      bool Ready(); //Have the pixels from the last Read() arrived?  Never blocks.
+
+      //Copy the pixels from the last Read() into dest, blocking until they arrive if needed.  dest must hold at least 
+      //as many bytes as were requested in Read().  Returns false if there was no Read() to Map().
+      bool Map(void* dest);
+
+    private:
+      GLuint fBufferID; //The OpenGL ID for the pixel buffer object
+      GLsync fFence; //Signaled once the GPU has finished the last Read()
+      size_t fBytes; //Size of the last Read()
+      size_t fCapacity; //Size of fBufferID's storage
+  };
+}
+
+#endif //MYGL_PIXELBUFFER_H
@@ -176,6 +176,13 @@ namespace mygl
     glUniform1i(location, value);
   }
 
+  void ShaderProg::SetUniform(const std::string& name, const unsigned int value)
+  {
+    Use();
+    auto location = glGetUniformLocation(fProgID, name.c_str());
+    glUniform1ui(location, value);
+  }
+
   void ShaderProg::SetUniform(const std::string& name, const float value)
   {
     Use();
@@ -34,6 +34,7 @@ namespace mygl
       //glUniform's documentation claims that it only works for the current program
       void SetUniform(const std::string& name, const float value);
       void SetUniform(const std::string& name, const int value); 
+      void SetUniform(const std::string& name, const unsigned int value);
       void SetUniform(const std::string& name, const float first, const float second);
       void SetUniform(const std::string& name, const glm::vec2& vec);
       void SetUniform(const std::string& name, const float first, const float second, const float third);
@@ -0,0 +1,53 @@
+//File: TimerQuery.cpp
+//Brief: Measures GPU time with a ring of GL_TIME_ELAPSED queries so that the CPU never waits for results.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//local includes
+#include "gl/objects/TimerQuery.h"
+
+namespace mygl
+{
+  constexpr size_t TimerQuery::nQueries;
+
+  TimerQuery::TimerQuery(): fNext(0), fOldest(0), fInFlight(0), fActive(false)
+  {
+    glGenQueries(nQueries, fQueryIDs.data());
+  }
+
+  TimerQuery::~TimerQuery()
+  {
+    glDeleteQueries(nQueries, fQueryIDs.data());
+  }
+
+  void TimerQuery::Begin()
+  {
+    if(fInFlight == nQueries) return; //The GPU is too far behind.  Skip this frame rather than wait for it.
+
+    glBeginQuery(GL_TIME_ELAPSED, fQueryIDs[fNext]);
+    fActive = true;
+  }
+
+  void TimerQuery::End()
+  {
+    if(!fActive) return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    fActive = false;
+    fNext = (fNext + 1) % nQueries;
+    ++fInFlight;
+  }
+
+  bool TimerQuery::Poll(GLuint64& nanoseconds)
+  {
+    if(fInFlight == 0) return false;
+
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(fQueryIDs[fOldest], GL_QUERY_RESULT_AVAILABLE, &available);
+    if(!available) return false;
+
+    glGetQueryObjectui64v(fQueryIDs[fOldest], GL_QUERY_RESULT, &nanoseconds);
+    fOldest = (fOldest + 1) % nQueries;
+    --fInFlight;
+    return true;
+  }
+}
@@ -0,0 +1,41 @@
+//File: TimerQuery.h
+//Brief: A TimerQuery measures how long the GPU spends on the commands between Begin() and End() with GL_TIME_ELAPSED 
+//       queries.  Results arrive a few frames later, so TimerQuery keeps a ring of queries and Poll() picks up whichever 
+//       have finished without waiting for the GPU.  Only one TimerQuery can be between Begin() and End() at a time.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef MYGL_TIMERQUERY_H
+#define MYGL_TIMERQUERY_H
+
+//glad includes
+#include "glad/include/glad/glad.h"
+
+//c++ includes
+#include <array>
+
+namespace mygl
+{
+  class TimerQuery
+  {
+    public:
+      TimerQuery();
+      virtual ~TimerQuery();
+
+      //Start and stop timing GPU commands.  If every query in the ring is still waiting for the GPU, this frame isn't timed.
+      void Begin();
+      void End();
+
+      //Returns true and sets nanoseconds to the oldest finished measurement if there is one.  Never blocks.
+      bool Poll(GLuint64& nanoseconds);
+
+    private:
+      static constexpr size_t nQueries = 4; //Frames a result can lag behind before measurements are dropped
+      std::array<GLuint, nQueries> fQueryIDs; //OpenGL IDs of the query ring
+      size_t fNext; //Next query to Begin()
+      size_t fOldest; //Oldest query that has been End()ed but not Poll()ed
+      size_t fInFlight; //Number of queries waiting to be Poll()ed
+      bool fActive; //Is this TimerQuery between Begin() and End()?
+  };
+}
+
+#endif //MYGL_TIMERQUERY_H
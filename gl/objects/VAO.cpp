@@ -71,6 +71,16 @@ namespace mygl
     return indOffset;
   }
 
+  unsigned int VAO::model::Register(const Drawable::Vertex* vertices, const size_t nVertices, const unsigned int* indices, const size_t nIndices)
+  {
+    const auto vertOffset = fVertices.size();
+    const auto indOffset = fIndices.size();
+    fVertices.insert(fVertices.end(), vertices, vertices + nVertices);
+    fIndices.reserve(indOffset + nIndices);
+    for(size_t index = 0; index < nIndices; ++index) fIndices.push_back(indices[index] + vertOffset);
+    return indOffset;
+  }
+
   VAO::sentry VAO::Use()
   {
     return sentry(fVAO);
@@ -44,6 +44,12 @@ namespace mygl
           unsigned int Register(const std::vector<Drawable::Vertex>& vertices); //Register vertices only to be used with glDrawArrays()
           unsigned int Register(const std::vector<Drawable::Vertex>& vertices, const std::vector<unsigned int>& indices); //Register vertices and indices to 
                                                                                                               //be used with glDrawElements()
+          //Same as above for vertices and indices that are not in a std::vector, like a memory-mapped file
+          unsigned int Register(const Drawable::Vertex* vertices, const size_t nVertices, const unsigned int* indices, const size_t nIndices);
+
+          //Everything Register()ed so far
+          const std::vector<Drawable::Vertex>& Vertices() const { return fVertices; }
+          const std::vector<unsigned int>& Indices() const { return fIndices; }
 
           friend class VAO; //Allow only VAO to access the data in a VAO::model
 
@@ -5,6 +5,7 @@
 
 //local includes
 #include "HistogramWindow.h"
+#include "gl/Profiler.h"
 
 //imgui includes
 #include "imgui_internal.h"
@@ -13,12 +14,173 @@
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
+#include <cstdlib>
+#include <numeric>
+#include <functional>
+#include <thread>
 
 namespace gui
 {
-  HistogramWindow::HistogramWindow(): fIncludeTopNodes(false), fLogX(false), fLogY(false) {}
+  namespace
+  {
+    constexpr size_t nBins = 100;
+    constexpr size_t minChunkSize = 1 << 15; //Fewest values worth starting a thread for
+
+    //Call func(chunk) for every chunk in [0, nChunks) on its own thread.  Chunk 0 runs on the calling thread.
+    template <class FUNC>
+    void ForEachChunk(const size_t nChunks, FUNC&& func)
+    {
+      std::vector<std::future<void>> others;
+      for(size_t chunk = 1; chunk < nChunks; ++chunk) others.push_back(std::async(std::launch::async, [&func, chunk]() { func(chunk); }));
+      func(0);
+      for(auto& other: others) other.get();
+    }
+  }
+
+  HistogramWindow::HistogramWindow(): fIncludeTopNodes(false), fLogX(false), fLogY(false), fRequestedKey(), fRequested(false), 
+                                     fBins(), fPending(), fCancel(false)
+  {
+  }
+
+  HistogramWindow::~HistogramWindow()
+  {
+    Cancel();
+  }
+
+  void HistogramWindow::Cancel()
+  {
+    if(fPending.valid())
+    {
+      fCancel = true;
+      fPending.wait();
+      fPending = std::future<bins_t>();
+    }
+    fCancel = false;
+    fRequested = false;
+  }
+
+  bool HistogramWindow::ParseFloat(const std::string& str, float& value)
+  {
+    //Same rules as std::stof(), but report failure instead of throwing
+    const char* begin = str.c_str();
+    char* end = nullptr;
+    value = std::strtof(begin, &end);
+    return end != begin;
+  }
+
+  void HistogramWindow::StartFill(std::vector<const std::string*>&& values)
+  {
+    if(values.size() < minChunkSize) fBins = Fill(values, fLogX, fLogY, fCancel);
+    else
+    {
+      const bool logX = fLogX, logY = fLogY;
+      fPending = std::async(std::launch::async, [this, logX, logY](const std::vector<const std::string*>& values)
+                                                { return Fill(values, logX, logY, fCancel); }, std::move(values));
+    }
+  }
+
+  HistogramWindow::bins_t HistogramWindow::Fill(const std::vector<const std::string*>& values, const bool logX, const bool logY,
+                                                const std::atomic<bool>& cancel)
+  {
+    mygl::Profiler::Scope timer("Histogram Fill");
+    const size_t nChunks = std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(), values.size()/minChunkSize));
+    const size_t chunkSize = (values.size() + nChunks - 1)/nChunks;
+    const auto chunkEnd = [&values, chunkSize](const size_t chunk) { return std::min(values.size(), (chunk+1)*chunkSize); };
+
+    //Parse each chunk as numbers.  Stop at the first value that isn't a number.
+    std::vector<HistogramModel<float>> numbers(nChunks);
+    std::vector<char> numeric(nChunks, true); //Not vector<bool> so that threads can write different elements
+    std::vector<size_t> nSuppressed(nChunks, 0);
+    ForEachChunk(nChunks, [&](const size_t chunk)
+                          {
+                            auto& model = numbers[chunk];
+                            const size_t end = chunkEnd(chunk);
+                            model.reserve(end - chunk*chunkSize);
+                            for(size_t pos = chunk*chunkSize; pos < end; ++pos)
+                            {
+                              if(pos % 4096 == 0 && cancel) return;
+                              float value;
+                              if(!ParseFloat(*values[pos], value))
+                              {
+                                numeric[chunk] = false;
+                                return;
+                              }
+
+                              if(!logX) model(value);
+                              else if(value > 0) model(std::log10(value)); //TODO: Handle negative values gracefully when in log mode
+                              else ++nSuppressed[chunk];
+                            }
+                          });
+    if(cancel) return bins_t();
+
+    bins_t bins;
+    if(std::all_of(numeric.begin(), numeric.end(), [](const char isNumber) { return isNumber; }))
+    {
+      const size_t suppressed = std::accumulate(nSuppressed.begin(), nSuppressed.end(), size_t(0));
+      if(suppressed > 0) std::cerr << "Suppressing " << suppressed << " values that are <= 0 because drawing log(x axis).\n";
+
+      float min = std::numeric_limits<float>::max(), max = std::numeric_limits<float>::lowest();
+      for(const auto& model: numbers)
+      {
+        min = std::min(min, model.Min());
+        max = std::max(max, model.Max());
+      }
+      if(max < min) return bins_t();
+
+      //Each thread bins its own values, then the partial histograms are summed
+      std::vector<std::vector<float>> counts(nChunks, std::vector<float>(nBins, 0));
+      ForEachChunk(nChunks, [&](const size_t chunk) { numbers[chunk].Bin(counts[chunk], min, max); });
+      for(size_t chunk = 1; chunk < nChunks; ++chunk)
+      {
+        std::transform(counts[chunk].begin(), counts[chunk].end(), counts.front().begin(), counts.front().begin(), std::plus<float>());
+      }
+      bins = HistogramModel<float>::Label(counts.front(), min, max);
+    }
+    else
+    {
+      numbers.clear();
+      std::vector<HistogramModel<std::string>> strings(nChunks);
+      ForEachChunk(nChunks, [&](const size_t chunk)
+                            {
+                              const size_t end = chunkEnd(chunk);
+                              for(size_t pos = chunk*chunkSize; pos < end; ++pos)
+                              {
+                                if(pos % 4096 == 0 && cancel) return;
+                                strings[chunk](*values[pos]);
+                              }
+                            });
+      if(cancel) return bins_t();
+
+      for(size_t chunk = 1; chunk < nChunks; ++chunk) strings.front().Merge(strings[chunk]);
+      bins = strings.front().BinData(nBins);
+      //Nothing to do for log x-axis with strings
+    }
 
-  void HistogramWindow::doDrawHistogram(std::vector<std::pair<std::string, float>>&& bins, const std::string& name)
+    if(logY) for(auto& bin: bins) bin.second = (bin.second>0)?std::log10(bin.second):0; //Protection against log(0) and log(negative number)
+    return bins;
+  }
+
+  bool HistogramWindow::DrawHistogram(const std::string& name)
+  {
+    bool open = true;
+    ImGui::Begin(name.c_str(), &open);
+ 
+    if(open) doDrawHistogram(fBins, name);
+    if(fPending.valid()) ImGui::Text("Filling histogram...");
+
+    //Drawing histogramming control GUI.  Changing any of these options invalidates the cached histogram.
+    ImGui::NewLine(); //TODO: Understand why axis labels aren't recognized as a line
+    ImGui::Checkbox("Include Top-level Nodes in Plots", &fIncludeTopNodes);
+    ImGui::SameLine();
+    ImGui::Checkbox("Log x axis", &fLogX);
+    ImGui::SameLine();
+    ImGui::Checkbox("Log y axis", &fLogY);
+
+    ImGui::End();
+    return open;
+  }
+
+  void HistogramWindow::doDrawHistogram(const bins_t& bins, const std::string& name)
   {
     if(bins.empty()) //For an empty set of bins, tell the user that there is no data
     {
@@ -26,9 +188,6 @@ namespace gui
       return;
     }
 
-    if(fLogY) for(auto& bin: bins) bin.second = (bin.second>0)?std::log10(bin.second):0; //Protection against log(0) and log(negative number)
-    //Nothing to do for log x-axis with strings
-
     //Render histogram the hard way
     ImVec2 graph_size(600, 400);
     const auto mostEntries = std::max_element(bins.begin(), bins.end(), 
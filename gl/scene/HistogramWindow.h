@@ -18,16 +18,20 @@
 #include <cstdlib>
 #include <string>
 #include <limits>
-#include <stdexcept>
+#include <cassert>
+#include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <future>
+#include <atomic>
+#include <chrono>
 
 namespace gui
 {
   template <class COMPARABLE>
   struct HistogramModel
   {
-    HistogramModel(): min(std::numeric_limits<COMPARABLE>::max()), max(std::numeric_limits<COMPARABLE>::min()) {}
+    HistogramModel(): min(std::numeric_limits<COMPARABLE>::max()), max(std::numeric_limits<COMPARABLE>::lowest()) {}
     ~HistogramModel() = default; 
 
     void operator()(const COMPARABLE value)
@@ -37,40 +41,63 @@ namespace gui
       if(value > max) max = value;
     }
 
-    std::vector<std::pair<std::string, float>> BinData(const size_t nBins)
-    {
-      assert(nBins > 1);
-      if(max < min) return  std::vector<std::pair<std::string, float>>();
-      const auto unitsPerBin = (max-min)/(nBins-1);
+    void reserve(const size_t nValues) { values.reserve(nValues); }
 
-      //Set up bins based on requested number of bins and min, max
-      std::map<float, float> bins; 
-      for(size_t bin = 0; bin < nBins; ++bin)
+    COMPARABLE Min() const { return min; }
+    COMPARABLE Max() const { return max; }
+
+    //Add values to counts.size() bins that are equal steps from lo with the last bin starting at hi.  Each value's 
+    //bin is found by index arithmetic instead of searching bin edges, so binning is linear in the number of values.
+    //Many HistogramModels can be binned into their own counts with the same lo and hi, then summed.
+    void Bin(std::vector<float>& counts, const COMPARABLE lo, const COMPARABLE hi) const
+    {
+      assert(!counts.empty());
+      if(!(lo < hi)) //All values are the same.  Put them in one bin.
       {
-        bins[bin * unitsPerBin + min] = 0;
+        counts.front() += values.size();
+        return;
       }
 
-      //Bin values
+      const size_t nBins = counts.size();
+      const double unitsPerBin = double(hi-lo)/(nBins-1);
       for(const auto& value: values) 
       {
-        assert(bins.upper_bound(value) != bins.begin());
-        ++(std::prev(bins.upper_bound(value))->second); //Last bin also gets overflows
+        const auto bin = std::min(size_t((value - lo)/unitsPerBin), nBins-1); //Last bin also gets overflows
+        ++counts[bin];
       }
+    }
+
+    //Stringify the lower bounds of bins filled by Bin()
+    static std::vector<std::pair<std::string, float>> Label(const std::vector<float>& counts, const COMPARABLE lo, const COMPARABLE hi)
+    {
+      if(!(lo < hi)) return std::vector<std::pair<std::string, float>>{std::make_pair(std::to_string(lo), counts.front())};
 
-      //Stringify bin lower bounds
+      const size_t nBins = counts.size();
+      const double unitsPerBin = double(hi-lo)/(nBins-1);
       std::vector<std::pair<std::string, float>> result;
-      for(const auto& bin: bins)
+      result.reserve(nBins);
+      for(size_t bin = 0; bin < nBins; ++bin)
       {
-        result.emplace_back(std::to_string(bin.first), bin.second);
+        result.emplace_back(std::to_string(bin * unitsPerBin + lo), counts[bin]);
       }
 
       return result;
     }
 
+    std::vector<std::pair<std::string, float>> BinData(const size_t nBins) const
+    {
+      assert(nBins > 1);
+      if(max < min) return  std::vector<std::pair<std::string, float>>();
+
+      std::vector<float> counts(nBins, 0);
+      Bin(counts, min, max);
+      return Label(counts, min, max);
+    }
+
     private:
       COMPARABLE min;
       COMPARABLE max;
-      std::vector<float> values;
+      std::vector<COMPARABLE> values;
   };
 
   //Each unique string gets its own bin.
@@ -86,6 +113,12 @@ namespace gui
       ++fBins[name];
     }
 
+    //Add other's bins to this HistogramModel's bins
+    void Merge(const HistogramModel& other)
+    {
+      for(const auto& bin: other.fBins) fBins[bin.first] += bin.second;
+    }
+
     std::vector<std::pair<std::string, float>> BinData(const size_t /*nBins*/) const
     {
       std::vector<std::pair<std::string, float>> binView;
@@ -101,118 +134,117 @@ namespace gui
   {
     public:
       HistogramWindow();
-      virtual ~HistogramWindow() = default;
+      virtual ~HistogramWindow();
 
-      //Return value indicates whether window is open
+      //Return value indicates whether window is open.  generation must change whenever which nodes 
+      //are visible or their contents might have changed.  The column is only read again from nodes 
+      //when nodes, col, generation, or the histogram options change.  Large columns are then binned 
+      //on worker threads, and the last finished histogram is drawn until the new one is ready.  
+      //Call Cancel() before destroying or changing nodes.
       template <class NODE>
-      bool Render(const std::list<NODE>& nodes, const size_t col, const std::string& name)
+      bool Render(const std::list<NODE>& nodes, const size_t col, const std::string& name, const size_t generation)
       {
-        try
+        const CacheKey key{&nodes, col, generation, fIncludeTopNodes, fLogX, fLogY};
+        if(!fRequested || !(key == fRequestedKey))
         {
-          //Get data to histogram
-          HistogramModel<float> model; 
-          //TODO: Those if() statements seem to significantly hurt performance of the application when I'm drawing a histogram.
-          //      Since I can't have interchangeable lambdas here, I should probably write some 
-          //      functor that does the model-filling and write versions with and without taking log.
-          auto fillFloat = [&model, &col, this](const auto& node)
-                           {
-                             if(!node.fVisible) return false; //Only plot visible nodes
-                             //TODO: Plot all nodes in another color
-
-                             const auto value = std::stof(node.row[col]);
-                             if(fLogX) 
-                             {
-                               if(value > 0) model(std::log10(value));
-                               else 
-                               {
-                                 std::cerr << "Suppressing value " << value << " that is <= 0 because drawing log(x axis).\n";
-                               }
-                             }
-                             else model(value); //TODO: Handle negative values gracefully when in log mode
-                             return true;
-                           };
-
-          for(const auto& top: nodes)
-          {
-            if(fIncludeTopNodes)
-            {
-              top.walkWhileTrue(fillFloat);
-            }
-            else
-            {
-              for(const auto& child: top.children)
-              {
-                child.walkWhileTrue(fillFloat);
-              }
-            }
-          }
-
-          return DrawHistogram(std::move(model), name);
+          Cancel();
+          StartFill(Extract(nodes, col));
+          fRequestedKey = key;
+          fRequested = true;
         }
-        catch(const std::invalid_argument& e)
+
+        if(fPending.valid() && fPending.wait_for(std::chrono::seconds(0)) == std::future_status::ready) fBins = fPending.get();
+
+        return DrawHistogram(name);
+      }
+
+      //Stop filling a histogram in the background.  Blocks until worker threads are no longer reading 
+      //the nodes last passed to Render().
+      void Cancel();
+
+      //Has a histogram finished filling in the background that Render() hasn't drawn yet?  Only while this window is 
+      //open: Cancel() it when it is closed or hidden.
+      bool NeedsFrame() const 
+      { 
+        return fRequested && fPending.valid() && fPending.wait_for(std::chrono::seconds(0)) == std::future_status::ready; 
+      }
+
+    private:
+      using bins_t = std::vector<std::pair<std::string, float>>;
+
+      //Everything that a histogram depends on
+      struct CacheKey
+      {
+        const void* fNodes; //Address of the list of top-level nodes histogrammed
+        size_t fColumn;
+        size_t fGeneration;
+        bool fIncludeTopNodes;
+        bool fLogX;
+        bool fLogY;
+
+        bool operator ==(const CacheKey& other) const
         {
-          /*std::cerr << "When trying to histogram " << name << ", got a value that is not convertible to float:\n"
-                    << e.what() << "\nTrying to plot strings instead.\n";*/
+          return fNodes == other.fNodes && fColumn == other.fColumn && fGeneration == other.fGeneration
+                 && fIncludeTopNodes == other.fIncludeTopNodes && fLogX == other.fLogX && fLogY == other.fLogY;
+        }
+      };
 
-          HistogramModel<std::string> model;
-          const auto fillString = [&model, &col](const auto& node)
-                                  {
-                                    if(!node.fVisible) return false; //Only plot visible nodes
-                                    //TODO: Plot all nodes in another color
+      //Column col of every visible node.  Walking the tree is cheap compared to parsing and binning, but 
+      //it has to happen on the thread that owns nodes.
+      template <class NODE>
+      std::vector<const std::string*> Extract(const std::list<NODE>& nodes, const size_t col) const
+      {
+        std::vector<const std::string*> values;
+        const auto fill = [&values, col](const auto& node)
+                          {
+                            if(!node.fVisible) return false; //Only plot visible nodes
+                            //TODO: Plot all nodes in another color
 
-                                    model(node.row[col]);
-                                    return true;
-                                  };
+                            values.push_back(&node.row[col]);
+                            return true;
+                          };
 
-          for(const auto& top: nodes)
+        for(const auto& top: nodes)
+        {
+          if(fIncludeTopNodes) top.walkIf(fill);
+          else
           {
-            if(fIncludeTopNodes)
-            {
-              top.walkWhileTrue(fillString);
-            }
-            else
-            {
-              for(const auto& child: top.children)
-              {
-                child.walkWhileTrue(fillString);
-              }
-            }
+            for(const auto& child: top.children) child.walkIf(fill);
           }
-
-          return DrawHistogram(std::move(model), name);
         }
+
+        return values;
       }
 
-    private:
+      //Parse the number at the start of str as a float without throwing.  Like std::stof(), anything after a 
+      //leading number is ignored, so "12abc" is 12.  Returns false if str doesn't start with a number.
+      static bool ParseFloat(const std::string& str, float& value);
+
+      //Bin values as numbers if they all are numbers or as strings otherwise.  Splits values across 
+      //threads that each fill their own histogram.  Gives up early if cancel is set.
+      static bins_t Fill(const std::vector<const std::string*>& values, const bool logX, const bool logY, 
+                         const std::atomic<bool>& cancel);
+
+      //Fill values now if there are only a few of them.  Otherwise, start filling them into fPending.
+      void StartFill(std::vector<const std::string*>&& values);
+
       //Create a window for histogram and controls.  Return whether window is still open
-      template <class COMPARABLE>
-      bool DrawHistogram(HistogramModel<COMPARABLE>&& model, const std::string& name)
-      {
-        bool open = true;
-        ImGui::Begin(name.c_str(), &open);
- 
-        constexpr size_t nBins = 100;
-        if(open) doDrawHistogram(model.BinData(nBins), name);
-
-        //Drawing histogramming control GUI
-        ImGui::NewLine(); //TODO: Understand why axis labels aren't recognized as a line
-        ImGui::Checkbox("Include Top-level Nodes in Plots", &fIncludeTopNodes);
-        ImGui::SameLine();
-        ImGui::Checkbox("Log x axis", &fLogX);
-        ImGui::SameLine();
-        ImGui::Checkbox("Log y axis", &fLogY);
-
-        ImGui::End();
-        return open;
-      }
+      bool DrawHistogram(const std::string& name);
 
       //Actually draw the histogram here.
-      void doDrawHistogram(std::vector<std::pair<std::string, float>>&& bins, const std::string& name);
+      void doDrawHistogram(const bins_t& bins, const std::string& name);
 
       //Data for histogram options
       bool fIncludeTopNodes; //Should top-level nodes be included in histograms?
       bool fLogX; //Should the x axis have a log scale?
       bool fLogY; //Should the y axis have a log scale?
+
+      //Histogram state
+      CacheKey fRequestedKey; //What the newest histogram is being made from
+      bool fRequested; //Has fRequestedKey been set since the last Cancel()?
+      bins_t fBins; //Newest finished histogram.  Drawn while fPending is filled.
+      std::future<bins_t> fPending; //Histogram for fRequestedKey while it is being filled
+      std::atomic<bool> fCancel; //Tells fPending's threads to stop early
   };
 }
 
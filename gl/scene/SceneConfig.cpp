@@ -28,6 +28,14 @@ namespace mygl
       {
         glDisable(GL_DEPTH_TEST);
       }
+
+      //Override these functions to let a Scene skip drawing objects that won't be seen.  
+      //If true, don't draw subtrees whose BoundingBoxes are completely outside the Camera's view.
+      virtual bool CullOutsideView() const { return false; }
+
+      //Draw a visible node without descending to its children if it covers fewer than this many pixels on screen.
+      //0 always draws children.
+      virtual float CollapsePixels() const { return 0; }
   };
 }
 
@@ -7,7 +7,9 @@
 #include "gl/metadata/Column.cpp"
 #include "SceneModel.cpp"
 #include "gl/model/Drawable.h"
+#include "gl/camera/Frustum.h"
 #include "SceneConfig.cpp"
+#include "gl/Profiler.h"
 
 //c++ includes
 #include <sstream>
@@ -19,44 +21,117 @@
 
 namespace ctrl
 {
+  constexpr uint32_t SceneController::noParent;
+
   //TODO: Maybe just pass in a ShaderProg to simplify constructors?  Does it matter anymore when a ShaderProg is created?  
   SceneController::SceneController(const std::string& fragSrc, const std::string& vertSrc, 
                                    std::shared_ptr<ColumnModel>& cols, 
                                    std::unique_ptr<mygl::SceneConfig>&& config): 
                                                       fCutBar(cols->size()), fCols(cols), fSelectedColumn(std::numeric_limits<size_t>::max()),
                                                       fHistWindow(), fConfig(std::move(config)), fShader(fragSrc, vertSrc),
-                                                      fSelectionShader(INSTALL_GLSL_DIR "/selection.frag", vertSrc)
+                                                      fSelectionShader(INSTALL_GLSL_DIR "/selection.frag", vertSrc), fGeneration(0), fCPUPicking(false), 
+                                                      fPickDrawn(), fPickDrawnValid(false), fPickWidth(0), fPickHeight(0), 
+                                                      fPickGeneration(0), fPickCull(false), fPickCollapse(0)
   {
   }
 
   SceneController::SceneController(const std::string& fragSrc, const std::string& vertSrc, const std::string& geomSrc, 
                std::shared_ptr<ColumnModel>& cols, std::unique_ptr<mygl::SceneConfig>&& config): fCutBar(cols->size()), 
                fCols(cols), fSelectedColumn(std::numeric_limits<size_t>::max()), fHistWindow(), fConfig(std::move(config)),
-               fShader(fragSrc, vertSrc, geomSrc), fSelectionShader(INSTALL_GLSL_DIR "/selection.frag", vertSrc, geomSrc)
+               fShader(fragSrc, vertSrc, geomSrc), fSelectionShader(INSTALL_GLSL_DIR "/selection.frag", vertSrc, geomSrc), 
+               fGeneration(0), fCPUPicking(false), fPickDrawn(), fPickDrawnValid(false), fPickWidth(0), fPickHeight(0),
+               fPickGeneration(0), fPickCull(false), fPickCollapse(0)
   {
   }
 
-  SceneController::~SceneController() {}
+  SceneController::~SceneController() 
+  {
+    fHistWindow.Cancel(); //fHistWindow might still be reading fCurrentModel's rows
+  }
 
   void SceneController::NewEvent(std::unique_ptr<model_t>&& newModel, mygl::VisID& nextID)
   {
+    //Don't pull the old model out from under a BVH that is still being built
+    {
+      mygl::Profiler::Scope timer("Stop background work");
+      if(fPickFuture.valid()) fPickFuture.wait();
+      fPickFuture = std::future<std::unique_ptr<PickIndex>>();
+      fPickIndex.reset();
+      fPickDrawnValid = false;
+      fHistWindow.Cancel(); //Same for a histogram that is still being filled
+    }
+
     fCurrentModel = std::move(newModel);
+    fSelectPath.clear(); //Selections were for the old model's nodes
     
-    //Set VisIDs for the entire model in a predictable pattern. 
-    for(auto& top: fCurrentModel->fTopLevelNodes) top.walk([this, &nextID](auto& child) { child.fVisID = nextID++; });
-    fVAO.Load(fCurrentModel->fVAO);
+    //Set VisIDs for the entire model in a predictable pattern.  VisIDs are contiguous in the order the tree is 
+    //walked, so node i in fNodes has VisID fFirstID + i.
+    {
+      mygl::Profiler::Scope timer("VisIDs");
+      fFirstID = nextID;
+      fNodes.clear();
+      fParents.clear();
+      std::vector<uint32_t> ancestors; //Indices in fNodes of the nodes above the node being visited
+      for(auto& top: fCurrentModel->fTopLevelNodes) 
+      {
+        top.walkIf([this, &nextID, &ancestors](auto& node) 
+                   { 
+                     node.fVisID = nextID++; 
+                     fParents.push_back(ancestors.empty()?noParent:ancestors.back());
+                     ancestors.push_back(fNodes.size());
+                     fNodes.push_back(&node);
+                     return true;
+                   }, 
+                   [&ancestors](auto& /*node*/) { ancestors.pop_back(); });
+      }
+    }
+
+    {
+      mygl::Profiler::Scope timer("VAO::Load");
+      fVAO.Load(fCurrentModel->fVAO);
+    }
+
+    //Each node's BoundingBox contains all of its descendants so that Render() can skip whole subtrees at once
+    {
+      mygl::Profiler::Scope timer("BoundingBoxes");
+      for(auto& top: fCurrentModel->fTopLevelNodes) 
+      {
+        top.walkIf([](auto& node) 
+                   { 
+                     node.fBounds = node.handle?node.handle->GetBounds():mygl::BoundingBox();
+                     return true; 
+                   }, 
+                   [](auto& node) { for(const auto& child: node.children) node.fBounds.Expand(child.fBounds); });
+      }
+    }
 
     //"remember" cut settings from last event
-    fCutBar.ApplyCut(fCurrentModel->fTopLevelNodes);
+    {
+      mygl::Profiler::Scope timer("ApplyCut");
+      fCutBar.ApplyCut(fCurrentModel->fTopLevelNodes);
+    }
 
     //Cache the last VisID in this scene for this event
     fLastID = nextID;
+    ++fGeneration;
+
+    if(fCPUPicking) StartPickIndex();
+  }
+
+  void SceneController::SetCut(const std::string& expr)
+  {
+    fCutBar.SetCut(expr);
+    if(fCurrentModel) fCutBar.ApplyCut(fCurrentModel->fTopLevelNodes);
+    ++fGeneration;
   }
 
   //Call this before Render() to get updates from user interaction with list tree.  
   void SceneController::RenderGUI()
   {
-    fCutBar.Render(fCurrentModel->fTopLevelNodes);
+    {
+      mygl::Profiler::Scope timer("Cuts");
+      if(fCutBar.Render(fCurrentModel->fTopLevelNodes)) ++fGeneration;
+    }
 
     //Tree column labels
     //Calculate the total length of text I will want to display
@@ -80,7 +155,12 @@ namespace ctrl
       if(selected)
       {
         fSelectedColumn = col;
-        if(!fHistWindow.Render(fCurrentModel->fTopLevelNodes, col, fCols->Name(col))) fSelectedColumn = std::numeric_limits<size_t>::max();
+        mygl::Profiler::Scope timer("Histogram");
+        if(!fHistWindow.Render(fCurrentModel->fTopLevelNodes, col, fCols->Name(col), fGeneration))
+        {
+          fHistWindow.Cancel(); //Don't keep filling a histogram that nobody will see
+          fSelectedColumn = std::numeric_limits<size_t>::max();
+        }
       }
       ImGui::NextColumn();
     }
@@ -128,20 +208,9 @@ namespace ctrl
     fShader.SetUniform("projection", persp);
     fShader.SetUniform("model", glm::mat4());  //In case Drawables don't set their own model matrices.  Setting the 
                                                //same uniform twice shouldn't be a problem, right?
-    for(auto& top: fCurrentModel->fTopLevelNodes) 
-    {
-      //top-level nodes have special meaning.  Don't try to Draw() their handles.  
-      if(top.fVisible)
-      {
-        for(auto& child: top.children)
-        {
-          child.walk([this](auto& node)
-                     {
-                       if(node.fVisible) node.handle->Draw(fShader);
-                     });
-        }
-      }
-    }
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    DrawVisible(view, persp, viewport[2], viewport[3], [this](auto& node) { node.handle->Draw(fShader); });
     fConfig->AfterRender();
   }
 
@@ -156,22 +225,40 @@ namespace ctrl
     fSelectionShader.SetUniform("model", glm::mat4());  //In case Drawables don't set their own model matrices.  Setting the 
                                                         //same uniform twice shouldn't be a problem, right?
 
-    for(auto& top: fCurrentModel->fTopLevelNodes)
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    DrawVisible(view, persp, viewport[2], viewport[3], [this](auto& node)
+                             {
+                               fSelectionShader.SetUniform("objectID", node.fVisID.fID); //Each VisID is a unique integer that can be drawn by opengl.  
+                                                                                         //So, draw this object with that integer so that it 
+                                                                                         //can be mapped back to its' VisID if the user clicks on it.
+                               node.handle->Draw(fSelectionShader);
+                             });
+  }
+
+  template <class FUNC>
+  void SceneController::DrawVisible(const glm::mat4& view, const glm::mat4& persp, const int width, const int height, FUNC&& draw)
+  {
+    const bool cull = fConfig->CullOutsideView();
+    const float collapse = fConfig->CollapsePixels();
+    const mygl::Frustum frustum(persp*view);
+
+    for(auto& top: fCurrentModel->fTopLevelNodes) 
     {
+      //top-level nodes have special meaning.  Don't try to Draw() their handles.  
       if(top.fVisible)
       {
         for(auto& child: top.children)
         {
-          child.walk([this](auto& node) 
-                     {
-                       if(node.fVisible)
+          child.walkIf([&](auto& node)
                        {
-                         fSelectionShader.SetUniform("idColor", node.fVisID); //Each VisID is a unique color that can be drawn by opengl.  
-                                                                              //So, draw this object with that color so that its' color 
-                                                                              //can be mapped back to its' VisID if the user clicks on it.
-                         node.handle->Draw(fSelectionShader);
-                       }
-                     });
+                         if(cull && frustum.Outside(node.fBounds)) return false;
+                         if(!node.fVisible) return true; //Children might still be visible
+                         
+                         draw(node);
+                         //Daughters of a node this small would only cover a few pixels inside it anyway
+                         return !(collapse > 0 && frustum.PixelSize(node.fBounds, width, height) < collapse);
+                       });
         }
       }
     }
@@ -180,59 +267,140 @@ namespace ctrl
   //TODO: Tell other SceneControllers that this VisID has been selected
   bool SceneController::SelectID(const mygl::VisID& searchID)
   {
-    //TODO: Rewrite this function to take advantage of list model instead.  If an object isn't 
-    //      visible, then no need to check whether its children are selected.  Furthermore, since 
-    //      I set VisIDs, I can ensure that VisIDs between siblings are children of the "lhs".  
-    //      I think this lets me write an algorithm something like a binary search tree (this one 
-    //      isn't binary though).  For the visibility check, I'd need something like walkWhileTrueIf().  
     //Regardless of what was selected, unselect the last thing that was selected
-    mygl::VisID oldSelected;
     if(!fSelectPath.empty()) 
     {
-      oldSelected = fSelectPath.front(); 
+      const auto oldSelected = fSelectPath.front(); 
       if(oldSelected == searchID) return true; //If the same object was selected twice in a row, we've found
                                                //and selected it with no effort!
+      auto old = FindNode(oldSelected);
+      if(old && old->handle) old->handle->SetBorder(0., glm::vec4(1., 0., 0., 1.));
     }
     fSelectPath.clear();
-    auto& top = fCurrentModel->fTopLevelNodes;
 
-    const auto compare = [](const auto& compareTo, const auto& node) { return compareTo < node.fVisID; };
-    const auto parentOfOldSelected = std::upper_bound(top.begin(), top.end(), oldSelected, compare);
-    if(parentOfOldSelected != top.begin())
+    auto found = FindNode(searchID);
+    if(!found) return false; //searchID isn't in this scene
+    if(found->handle) found->handle->SetBorder(0.01, glm::vec4(1., 0., 0., 1.));
+
+    //The path starts with the selected node and ends with its top-level node
+    for(auto index = searchID.fID - fFirstID.fID; index != noParent; index = fParents[index]) fSelectPath.push_back(fNodes[index]->fVisID);
+    return true;
+  }
+
+  SceneController::node_t* SceneController::FindNode(const mygl::VisID& id) const
+  {
+    if(!fCurrentModel || id < fFirstID || !(id < fLastID)) return nullptr;
+    return fNodes[id.fID - fFirstID.fID];
+  }
+
+  void SceneController::HideGUI()
+  {
+    fHistWindow.Cancel();
+  }
+
+  void SceneController::EnableCPUPicking(const bool enable)
+  {
+    fCPUPicking = enable;
+    if(fCPUPicking && fCurrentModel && !fPickIndex && !fPickFuture.valid()) StartPickIndex();
+  }
+
+  void SceneController::StartPickIndex()
+  {
+    fPickFuture = std::async(std::launch::async, [this]() { return BuildPickIndex(); });
+  }
+
+  std::unique_ptr<SceneController::PickIndex> SceneController::BuildPickIndex() const
+  {
+    auto index = std::make_unique<PickIndex>();
+
+    //Give every primitive from the same node the same owner
+    class Sink: public mygl::Drawable::PrimitiveSink
     {
-      //TODO: If selection is very slow, this is the first place to suspect.  A good 
-      //      alternative would be caching a handle somehow.
-      std::prev(parentOfOldSelected)->search([this, &oldSelected](auto& node)
-                                             {
-                                               if(node.handle && node.fVisID == oldSelected) node.handle->SetBorder(0., glm::vec4(1., 0., 0., 1.));
-                                             }, oldSelected);
-    }
+      public:
+        Sink(mygl::BVH& bvh): fBVH(bvh), fOwner(0) {}
+
+        void Triangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) override { fBVH.AddTriangle(a, b, c, fOwner); }
+        void Segment(const glm::vec3& a, const glm::vec3& b) override { fBVH.AddSegment(a, b, fOwner); }
+        void Point(const glm::vec3& point) override { fBVH.AddPoint(point, fOwner); }
 
-    //If searchID can't possibly be in this scene, return now
-    if(!(searchID < fLastID))
+        mygl::BVH& fBVH;
+        uint32_t fOwner; //Owner of the next primitive
+    } sink(index->fBVH);
+
+    const auto& vertices = fCurrentModel->fVAO.Vertices();
+    const auto& indices = fCurrentModel->fVAO.Indices();
+    for(const auto& top: fCurrentModel->fTopLevelNodes)
     {
-      return false;
+      for(const auto& child: top.children)
+      {
+        child.walk([&](const auto& node)
+                   {
+                     sink.fOwner = index->fNodes.size();
+                     index->fNodes.push_back(&node);
+                     node.handle->Primitives(vertices.data(), indices.data(), sink);
+                   });
+      }
     }
-                                             
-    //Now, find the next object to be selected
-    const auto parentOfSelected = std::upper_bound(top.begin(), top.end(), searchID, compare);
-    if(parentOfSelected == top.begin()) 
+
+    index->fBVH.Build();
+    return index;
+  }
+
+  bool SceneController::Pick(const mygl::BVH::Ray& ray, const glm::mat4& view, const glm::mat4& persp, const int width, const int height, 
+                             mygl::VisID& id, float& distance)
+  {
+    if(!fCurrentModel) return false;
+    if(!fPickIndex)
     {
-      return false;
+      if(!fPickFuture.valid()) StartPickIndex();
+      fPickIndex = fPickFuture.get();
     }
- 
-    //Since fVisID assignment descends the list tree before going to the next node, all children of a given node are ordered by 
-    //fVisID.  So, if I ever reach a point where walkWhileTrue() returns false, I've either found searchID, or it isn't in 
-    //fCurrentModel at all.  
-    if(!std::prev(parentOfSelected)->search([this, &searchID](auto& node)
-                                            {
-                                              fSelectPath.push_back(node.fVisID);
-                                              if(node.fVisID == searchID) node.handle->SetBorder(0.01, glm::vec4(1., 0., 0., 1.));
-                                            }, searchID))
+
+    //Same visibility rules as Render(), including culling outside the view and collapsing small nodes
+    UpdatePickDrawn(view, persp, width, height);
+
+    const auto& index = *fPickIndex;
+    const auto first = fFirstID.fID;
+    mygl::BVH::Hit hit;
+    if(!index.fBVH.Intersect(ray, [this, &index, first](const uint32_t owner) { return fPickDrawn[index.fNodes[owner]->fVisID.fID - first]; }, hit)) 
     {
-      fSelectPath.clear();
       return false;
     }
+
+    id = index.fNodes[hit.fOwner]->fVisID;
+    distance = hit.fDistance;
+    return true;
+  }
+
+  void SceneController::UpdatePickDrawn(const glm::mat4& view, const glm::mat4& persp, const int width, const int height)
+  {
+    const bool cull = fConfig->CullOutsideView();
+    const float collapse = fConfig->CollapsePixels();
+    if(fPickDrawnValid && view == fPickView && persp == fPickPersp && width == fPickWidth && height == fPickHeight 
+       && fGeneration == fPickGeneration && cull == fPickCull && collapse == fPickCollapse) return;
+
+    fPickDrawn.assign(fNodes.size(), false);
+    const auto first = fFirstID.fID;
+    DrawVisible(view, persp, width, height, [this, first](const auto& node) { fPickDrawn[node.fVisID.fID - first] = true; });
+
+    fPickDrawnValid = true;
+    fPickView = view;
+    fPickPersp = persp;
+    fPickWidth = width;
+    fPickHeight = height;
+    fPickGeneration = fGeneration;
+    fPickCull = cull;
+    fPickCollapse = collapse;
+  }
+
+  bool SceneController::RenderTooltip(const mygl::VisID& id)
+  {
+    const auto found = FindNode(id);
+    if(!found) return false;
+
+    ImGui::BeginTooltip();
+    for(size_t col = 0; col < fCols->size(); ++col) ImGui::Text("%s: %s", fCols->Name(col).c_str(), found->row[col].c_str());
+    ImGui::EndTooltip();
     return true;
   }
 
@@ -263,6 +431,7 @@ namespace ctrl
     {
       const bool visible = node.fVisible;
       node.walk([&visible](auto& child) { child.fVisible = visible; });
+      ++fGeneration;
     }
     ImGui::NextColumn();
 
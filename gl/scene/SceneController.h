@@ -66,6 +66,7 @@
 #include "gl/objects/ShaderProg.h"
 #include "gl/objects/VAO.h"
 #include "gl/scene/HistogramWindow.h"
+#include "gl/selection/BVH.h"
 
 //glm includes
 #include <glm/glm.hpp>
@@ -74,6 +75,7 @@
 #include <limits>
 #include <memory>
 #include <vector>
+#include <future>
 
 #ifndef VIEW_SCENE_H
 #define VIEW_SCENE_H
@@ -116,15 +118,60 @@ namespace ctrl
       //Functions for drawing objects associated with this Scene
       virtual void Render(const glm::mat4& view, const glm::mat4& persp);
       virtual void RenderGUI();
+
+      //RenderGUI() won't be called for a while.  Stops filling a histogram in the background.  It is filled again 
+      //the next time RenderGUI() is called.
+      void HideGUI();
       virtual void RenderSelection(const glm::mat4& view, const glm::mat4& persp);
 
       //Function for applying object selection
       bool SelectID(const mygl::VisID& id);
 
+      //Cut on metadata as if the user had typed expr into the cut bar.  The cut is kept for future events.
+      void SetCut(const std::string& expr);
+
+      //Show the metadata for id in a tooltip if id is in this Scene.  Returns whether id was found.  
+      bool RenderTooltip(const mygl::VisID& id);
+
+      //CPU picking.  Find the closest object along ray that Render(view, persp) would draw in a width x height viewport.  
+      //Waits for this event's BVH if it is still being built, and builds it now if CPU picking was never enabled.  
+      //Doesn't need an opengl context.  Returns whether anything was hit.
+      bool Pick(const mygl::BVH::Ray& ray, const glm::mat4& view, const glm::mat4& persp, const int width, const int height, 
+                mygl::VisID& id, float& distance);
+
+      //Build a BVH for CPU picking in the background every time a new event is loaded
+      void EnableCPUPicking(const bool enable);
+
+      //Changes every time what RenderSelection() would draw changes for reasons other than the Camera: 
+      //new events, visibility, and cuts.
+      size_t Generation() const { return fGeneration; }
+
+      //Has work finished in the background that needs a new frame to show up?
+      bool NeedsFrame() const { return fHistWindow.NeedsFrame(); }
+
     protected:
       //Helper functions for drawing tree
       bool DrawNodeData(node_t& node);
 
+      //Node with id in the current event or nullptr if id isn't in this Scene.  Constant time.
+      node_t* FindNode(const mygl::VisID& id) const;
+
+      //Everything needed to map a ray to a VisID for one event
+      struct PickIndex
+      {
+        mygl::BVH fBVH; 
+        std::vector<const node_t*> fNodes; //Node that drew each owner in fBVH
+      };
+
+      std::unique_ptr<PickIndex> BuildPickIndex() const; //Safe to call from another thread while rendering
+      void StartPickIndex(); //Start BuildPickIndex() for the current event in the background
+
+      //Call draw() on every visible node that the Camera described by view and persp might see in a width x height 
+      //viewport.  Skips subtrees outside the view and stops descending at nodes that are too small to see 
+      //any detail in if fConfig asks for it.  Makes no opengl calls.
+      template <class FUNC>
+      void DrawVisible(const glm::mat4& view, const glm::mat4& persp, const int width, const int height, FUNC&& draw);
+
     private: 
       //Data for GUI operations
       std::vector<mygl::VisID> fSelectPath; //The path to the currently-selected Node
@@ -133,19 +180,42 @@ namespace ctrl
       //Data for working with current ColumnModel
       std::shared_ptr<ColumnModel> fCols; //Columns displayed by this Scene
       size_t fSelectedColumn; //The column that is currently selected for histogramming if any
-      gui::HistogramWindow fHistWindow; //Histogram window for the currently selected column
+      gui::HistogramWindow fHistWindow; //Histogram window for the currently selected column.  Cancel() it before fCurrentModel changes.
 
       //OpenGL rendering data used for all events
       std::unique_ptr<mygl::SceneConfig> fConfig; //User handle to configure openGL just before and after rendering. 
       mygl::ShaderProg fShader; //The opengl shader program with which the objects in fDrawables will be rendered
       mygl::ShaderProg fSelectionShader; //Same components as fShader except for the fragment shader.  This program 
                                    //uses a special (unique?) fragment shader to which it can bind a VisID as 
-                                   //a color.
+                                   //an integer.
       mygl::VAO fVAO; //A place to store vertices on the GPU 
 
       //Data specific to the current event
       std::unique_ptr<model_t> fCurrentModel; //The SceneModel that is currently being drawn
-      mygl::VisID fLastID; //Makes binary searches potentially faster
+      mygl::VisID fFirstID; //VisID of the first node in the current event
+      mygl::VisID fLastID; //One past the VisID of the last node in the current event
+      std::vector<node_t*> fNodes; //Every node in the current event indexed by VisID - fFirstID
+      std::vector<uint32_t> fParents; //Index in fNodes of each node's parent or noParent for top-level nodes
+      static constexpr uint32_t noParent = std::numeric_limits<uint32_t>::max();
+      size_t fGeneration; //Incremented whenever the set of visible objects might have changed
+
+      //CPU picking for the current event.  fPickFuture must be destroyed before fCurrentModel.
+      bool fCPUPicking; //Build fPickIndex for every new event?
+      std::future<std::unique_ptr<PickIndex>> fPickFuture; //fPickIndex while it is being built
+      std::unique_ptr<PickIndex> fPickIndex; //Retrieved from fPickFuture when first needed
+
+      //Which nodes DrawVisible() would draw for the last Pick(), indexed like fNodes.  Only found again when the 
+      //Camera, viewport, fGeneration, or culling settings change so that most picks are just a BVH query.
+      void UpdatePickDrawn(const glm::mat4& view, const glm::mat4& persp, const int width, const int height);
+      std::vector<char> fPickDrawn; //Not std::vector<bool> so that lookups are fast
+      bool fPickDrawnValid; //Has fPickDrawn been filled for the current event?
+      glm::mat4 fPickView;
+      glm::mat4 fPickPersp;
+      int fPickWidth;
+      int fPickHeight;
+      size_t fPickGeneration;
+      bool fPickCull; //fConfig->CullOutsideView() when fPickDrawn was filled
+      float fPickCollapse; //fConfig->CollapsePixels() when fPickDrawn was filled
   };
 }
 
@@ -70,6 +70,10 @@ namespace ctrl
         return view(node, *fCols, fVAO);
       }
 
+      //Read-only views of what a plugin put in this SceneModel for tools that never draw it, like benchmarks
+      const std::list<TreeNode<std::unique_ptr<HANDLE>>>& TopLevelNodes() const { return fTopLevelNodes; }
+      const mygl::VAO::model& VAOModel() const { return fVAO; }
+
       friend class SceneController; //Allow SceneController to access protected members of SceneModel so that 
                                     //user can set up SceneModel without being able to do OpenGL rendering.  
 
@@ -0,0 +1,145 @@
+//File: BVH.cpp
+//Brief: A bounding volume hierarchy for finding what a ray from the Camera hits.  Nodes are split at the median 
+//       primitive along their longest axis.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//local includes
+#include "gl/selection/BVH.h"
+
+//c++ includes
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  constexpr uint32_t maxLeafSize = 4; 
+  constexpr size_t maxDepth = 60; //Leave room on Intersect()'s stack for one extra Node per level
+}
+
+namespace mygl
+{
+  void BVH::AddTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const uint32_t owner)
+  {
+    Add(Primitive{a, b, c, glm::min(a, glm::min(b, c)), glm::max(a, glm::max(b, c)), owner, Type::Triangle});
+  }
+
+  void BVH::AddSegment(const glm::vec3& a, const glm::vec3& b, const uint32_t owner)
+  {
+    Add(Primitive{a, b, b, glm::min(a, b), glm::max(a, b), owner, Type::Segment});
+    fHasWide = true;
+  }
+
+  void BVH::AddPoint(const glm::vec3& point, const uint32_t owner)
+  {
+    Add(Primitive{point, point, point, point, point, owner, Type::Point});
+    fHasWide = true;
+  }
+
+  void BVH::Add(const Primitive& prim)
+  {
+    fPrimitives.push_back(prim);
+  }
+
+  void BVH::Build()
+  {
+    fNodes.clear();
+    if(fPrimitives.empty()) return;
+    fNodes.reserve(2*fPrimitives.size()/maxLeafSize+1);
+    Split(0, fPrimitives.size(), 0);
+  }
+
+  void BVH::Split(const uint32_t begin, const uint32_t end, const size_t depth)
+  {
+    const auto index = fNodes.size();
+    fNodes.push_back(Node{fPrimitives[begin].fMin, fPrimitives[begin].fMax, begin, end - begin});
+    for(auto prim = begin+1; prim < end; ++prim)
+    {
+      fNodes[index].fMin = glm::min(fNodes[index].fMin, fPrimitives[prim].fMin);
+      fNodes[index].fMax = glm::max(fNodes[index].fMax, fPrimitives[prim].fMax);
+    }
+
+    if(end - begin <= maxLeafSize || depth >= maxDepth) return;
+
+    //Split at the median center along the longest axis
+    const auto size = fNodes[index].fMax - fNodes[index].fMin;
+    const int axis = (size.x > size.y)?((size.x > size.z)?0:2):((size.y > size.z)?1:2);
+    const auto middle = begin + (end - begin)/2;
+    std::nth_element(fPrimitives.begin() + begin, fPrimitives.begin() + middle, fPrimitives.begin() + end, 
+                     [axis](const Primitive& lhs, const Primitive& rhs) 
+                     { 
+                       return lhs.fMin[axis] + lhs.fMax[axis] < rhs.fMin[axis] + rhs.fMax[axis]; 
+                     });
+
+    Split(begin, middle, depth+1);
+    const auto right = fNodes.size();
+    Split(middle, end, depth+1);
+
+    fNodes[index].fStart = right;
+    fNodes[index].fCount = 0;
+  }
+
+  bool BVH::HitsBox(const Ray& ray, const glm::vec3& inverse, const Node& node, const float maxDist) const
+  {
+    //Grow the box by the largest radius a segment or point could have along this part of the ray
+    const float pad = fHasWide?(ray.fRadius + ray.fRadiusSlope*maxDist):0.f;
+    const auto low = (node.fMin - pad - ray.fOrigin)*inverse, high = (node.fMax + pad - ray.fOrigin)*inverse;
+    const auto near = glm::min(low, high), far = glm::max(low, high);
+    const float enter = std::max(std::max(near.x, near.y), std::max(near.z, 0.f));
+    const float exit = std::min(std::min(far.x, far.y), std::min(far.z, maxDist));
+    return enter <= exit;
+  }
+
+  bool BVH::HitsPrimitive(const Ray& ray, const Primitive& prim, float& dist)
+  {
+    if(prim.fType == Type::Triangle)
+    {
+      //Moller-Trumbore intersection
+      const auto edge1 = prim.fB - prim.fA, edge2 = prim.fC - prim.fA;
+      const auto p = glm::cross(ray.fDirection, edge2);
+      const float det = glm::dot(edge1, p);
+      if(std::fabs(det) < std::numeric_limits<float>::epsilon()) return false; //Ray is parallel to triangle
+      const float invDet = 1.f/det;
+
+      const auto toOrigin = ray.fOrigin - prim.fA;
+      const float u = glm::dot(toOrigin, p)*invDet;
+      if(u < 0.f || u > 1.f) return false;
+      
+      const auto q = glm::cross(toOrigin, edge1);
+      const float v = glm::dot(ray.fDirection, q)*invDet;
+      if(v < 0.f || u + v > 1.f) return false;
+
+      dist = glm::dot(edge2, q)*invDet;
+      return dist >= 0.f;
+    }
+
+    float along = 0.f; //Distance along the ray to the closest approach
+    glm::vec3 closest; //Closest point on the primitive to the ray
+    if(prim.fType == Type::Point)
+    {
+      closest = prim.fA;
+      along = glm::dot(closest - ray.fOrigin, ray.fDirection);
+    }
+    else
+    {
+      //Closest points between the ray and a segment.  See Ericson, "Real-Time Collision Detection", section 5.1.9.
+      const auto segment = prim.fB - prim.fA;
+      const auto toOrigin = ray.fOrigin - prim.fA;
+      const float length2 = glm::dot(segment, segment);
+      const float b = glm::dot(ray.fDirection, segment), c = glm::dot(ray.fDirection, toOrigin), f = glm::dot(segment, toOrigin);
+      const float denom = length2 - b*b; //Ray direction is normalized
+      float s = (denom > std::numeric_limits<float>::epsilon())?std::min(std::max((f - b*c)/denom, 0.f), 1.f):0.f;
+      const float t = std::max(b*s - c, 0.f); //The ray starts at its origin
+      if(length2 > 0.f) s = std::min(std::max((f + b*t)/length2, 0.f), 1.f);
+      closest = prim.fA + s*segment;
+      along = glm::dot(closest - ray.fOrigin, ray.fDirection);
+    }
+
+    if(along < 0.f) return false;
+    const auto offset = ray.fOrigin + along*ray.fDirection - closest;
+    const float radius = ray.fRadius + ray.fRadiusSlope*along;
+    if(glm::dot(offset, offset) > radius*radius) return false;
+
+    dist = along;
+    return true;
+  }
+}
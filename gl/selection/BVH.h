@@ -0,0 +1,133 @@
+//File: BVH.h
+//Brief: A bounding volume hierarchy over the triangles, line segments, and points that a Scene draws.  Lets the CPU find 
+//       the object under the mouse by casting a ray from the Camera without drawing anything.  Add primitives, call Build() 
+//       once, then Intersect() as many rays as you want.  Each primitive has an owner that the user can map back to the 
+//       object that drew it.  
+//
+//       Line segments and points are drawn wider than they really are by geometry shaders, so a ray hits one if 
+//       it passes within a radius that grows linearly along the ray.  That makes the radius a constant number of pixels 
+//       for both perspective and orthographic projections.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef MYGL_BVH_H
+#define MYGL_BVH_H
+
+//glm includes
+#include <glm/glm.hpp>
+
+//c++ includes
+#include <vector>
+#include <cstdint>
+#include <limits>
+
+namespace mygl
+{
+  class BVH
+  {
+    public:
+      BVH() = default;
+      virtual ~BVH() = default;
+
+      struct Ray
+      {
+        glm::vec3 fOrigin; 
+        glm::vec3 fDirection; //Must be normalized
+        float fLength; //Ignore anything farther than this from fOrigin
+        float fRadius; //Line segments and points within fRadius + fRadiusSlope*distance of the ray are hit
+        float fRadiusSlope; 
+      };
+
+      struct Hit
+      {
+        uint32_t fOwner; //Owner of the primitive that was hit
+        float fDistance; //Distance along the ray to the hit
+      };
+
+      //Add primitives before Build()ing
+      void AddTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const uint32_t owner);
+      void AddSegment(const glm::vec3& a, const glm::vec3& b, const uint32_t owner);
+      void AddPoint(const glm::vec3& point, const uint32_t owner);
+
+      //Organize primitives into a hierarchy.  Must be called before Intersect().
+      void Build();
+
+      //Find the closest primitive along ray whose owner passes accept.  Returns whether anything was hit.
+      template <class FILTER> //FILTER is a callable object that takes a uint32_t owner and returns true if it can be hit
+      bool Intersect(const Ray& ray, FILTER&& accept, Hit& hit) const
+      {
+        if(fNodes.empty()) return false;
+
+        hit.fDistance = std::numeric_limits<float>::max();
+        bool found = false;
+        const glm::vec3 inverse(1.f/ray.fDirection.x, 1.f/ray.fDirection.y, 1.f/ray.fDirection.z);
+
+        //Depth-first traversal with an explicit stack
+        uint32_t stack[64];
+        size_t depth = 0;
+        stack[depth++] = 0;
+        while(depth > 0)
+        {
+          const auto& node = fNodes[stack[--depth]];
+          const float maxDist = std::min(hit.fDistance, ray.fLength);
+          if(!HitsBox(ray, inverse, node, maxDist)) continue;
+
+          if(node.fCount > 0) //Leaf
+          {
+            for(uint32_t prim = node.fStart; prim < node.fStart + node.fCount; ++prim)
+            {
+              float dist = 0;
+              if(HitsPrimitive(ray, fPrimitives[prim], dist) && dist < hit.fDistance && dist <= ray.fLength && accept(fPrimitives[prim].fOwner))
+              {
+                hit.fDistance = dist;
+                hit.fOwner = fPrimitives[prim].fOwner;
+                found = true;
+              }
+            }
+          }
+          else
+          {
+            stack[depth++] = node.fStart; //Right child
+            stack[depth++] = &node - fNodes.data() + 1; //Left child is always next
+          }
+        }
+
+        return found;
+      }
+
+      size_t size() const { return fPrimitives.size(); } //Number of primitives added
+
+    private:
+      enum class Type: uint8_t { Triangle, Segment, Point };
+
+      struct Primitive
+      {
+        glm::vec3 fA; 
+        glm::vec3 fB; //Unused for points
+        glm::vec3 fC; //Unused for points and segments
+        glm::vec3 fMin; //Bounding box
+        glm::vec3 fMax;
+        uint32_t fOwner; 
+        Type fType;
+      };
+
+      struct Node
+      {
+        glm::vec3 fMin; //Bounding box of everything below this Node
+        glm::vec3 fMax;
+        uint32_t fStart; //First primitive for leaves.  Index of right child otherwise.
+        uint32_t fCount; //Number of primitives for leaves.  0 otherwise.
+      };
+
+      std::vector<Primitive> fPrimitives; //Sorted so that each leaf's primitives are contiguous after Build()
+      std::vector<Node> fNodes; //Root is first.  Left child of each Node immediately follows it.
+      bool fHasWide = false; //Are there any segments or points?  Their radius grows Nodes' boxes when searching.
+
+      void Add(const Primitive& prim);
+      void Split(const uint32_t begin, const uint32_t end, const size_t depth); //Recursively make Nodes for [begin, end)
+
+      bool HitsBox(const Ray& ray, const glm::vec3& inverse, const Node& node, const float maxDist) const;
+      static bool HitsPrimitive(const Ray& ray, const Primitive& prim, float& dist);
+  };
+}
+
+#endif //MYGL_BVH_H
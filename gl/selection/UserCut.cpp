@@ -10,6 +10,7 @@
 //c++ includes
 #include <string>
 #include <regex>
+#include <algorithm>
 
 namespace mygl
 {
@@ -18,6 +19,19 @@ namespace mygl
   {   
   }
 
+  void UserCut::SetCut(const std::string& expr)
+  {
+    if(expr.size() >= fBufferDepth) 
+    {
+      throw util::GenException("Cut Too Long") << "Cut " << expr << " is longer than the " << fBufferDepth-1 
+                                               << " characters that the cut bar can hold.\n";
+    }
+
+    fInput.fill('\0');
+    std::copy(expr.begin(), expr.end(), fInput.begin());
+    fBuffer = fInput;
+  }
+
   bool UserCut::do_filter(const ctrl::Row& row) 
   {
     std::string copy(fInput.data());
@@ -55,9 +55,10 @@ namespace mygl
 
       //Render this cut bar and apply its result
       //to the tree that starts at this list of 
-      //root NODEs.  
+      //root NODEs.  Returns true if the cut was 
+      //applied again.
       template <class NODE> //NODE shall have members fVisible and row 
-      void Render(std::list<NODE>& root)
+      bool Render(std::list<NODE>& root)
       {
         //Cut bar
         const bool newCut = ImGui::InputText("##Cut", fBuffer.data(), fBuffer.size(), ImGuiInputTextFlags_EnterReturnsTrue);
@@ -107,8 +108,13 @@ namespace mygl
 
         //Apply cut
         if(newCut || settingsChanged) ApplyCut(root);
+        return newCut || settingsChanged;
       }
  
+      //Replace the cut with expr as if the user had typed it into the cut bar.  Call ApplyCut() to use it.  Throws a 
+      //util::GenException if expr is too long for the cut bar.
+      void SetCut(const std::string& expr);
+
       //Just apply cuts, but don't render a GUI.  Publicly useful to "remember" cuts immediately 
       //after loading a new event.  
       template <class NODE>
@@ -8,33 +8,13 @@
 
 namespace mygl
 {
-  VisID::VisID(const unsigned char r, const unsigned char g, const unsigned char b): fR(r), fG(g), fB(b)
-  {
-  }
-
-  VisID::operator glm::vec4() const
-  {
-    return glm::vec4(fR/255.0f, fG/255.0f, fB/255.0f, 1.0f);
-  }
-
   VisID& VisID::operator ++() //prefix
   {
-    //Handle overflows
-    const auto max = std::numeric_limits<unsigned char>::max();
-    if(fB == max)
-    {
-      fB = 0;
-      if(fG == max)
-      {
-        fG = 0;
-        if(fR == max) throw util::GenException("Max VisID") << "Reached maximum VisID!  Identifiers for Drawables in "
-                                                            << "Scenes are no longer unique.  This will interferer with "
-                                                            << "object selection.\n";
-        else ++fR;
-      }
-      else ++fG;
-    }
-    else ++fB;
+    //Handle overflows.  The largest VisID is reserved for None().
+    if(fID + 1 == None().fID) throw util::GenException("Max VisID") << "Reached maximum VisID!  Identifiers for Drawables in "
+                                                                    << "Scenes are no longer unique.  This will interferer with "
+                                                                    << "object selection.\n";
+    ++fID;
     return *this;
   }
 
@@ -47,21 +27,18 @@ namespace mygl
 
   bool VisID::operator <(const VisID& rhs) const
   {
-    if(fR != rhs.fR) return (fR < rhs.fR);
-    if(fG != rhs.fG) return (fG < rhs.fG);
-    return (fB < rhs.fB);
+    return fID < rhs.fID;
   }
 
   bool VisID::operator ==(const VisID& rhs) const
   {
-    return (fR == rhs.fR) && (fG == rhs.fG) && (fB == rhs.fB);
+    return fID == rhs.fID;
   }
 
-
   //Printing interface for VisID
   std::ostream& operator <<(std::ostream& os, const VisID& id)
   {
-    os << "(" << +(id.fR) << ", " << +(id.fG) << ", " << +(id.fB) << ")";
+    os << id.fID;
     return os;
   }
 }
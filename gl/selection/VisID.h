@@ -1,12 +1,13 @@
 //File: VisID.h
-//Brief: An identifier for visualization objects that can be easily converted to a color that opengl can draw.
+//Brief: An identifier for visualization objects that can be drawn into an integer framebuffer by opengl.  VisIDs are 
+//       handed out in increasing order as a Scene's tree is walked, so comparing VisIDs tells where objects are in 
+//       that tree.
 //Author: Andrew Olivier aolivier@ur.rochester.edu
 
-//glm includes
-#include <glm/glm.hpp>
-
 //c++ includes
 #include <iostream>
+#include <cstdint>
+#include <limits>
 
 #ifndef MYGL_VISID_H
 #define MYGL_VISID_H
@@ -15,13 +16,12 @@ namespace mygl
 {
   struct VisID
   {
-    unsigned char fR;
-    unsigned char fG;
-    unsigned char fB;
-  
-    VisID(const unsigned char r=0, const unsigned char g=0, const unsigned char b=0);
+    uint32_t fID; //Fits in one pixel of a GL_R32UI framebuffer
   
-    operator glm::vec4() const;
+    constexpr VisID(const uint32_t id = 0): fID(id) {}
+
+    //A VisID that is never given to any object.  Selection framebuffers are cleared to this value.
+    static constexpr VisID None() { return VisID(std::numeric_limits<uint32_t>::max()); }
   
     VisID& operator ++(); //prefix
     VisID operator ++(int); //postfix
@@ -35,4 +35,3 @@ namespace mygl
 }
 
 #endif //MYGL_VISID_H
-
@@ -0,0 +1,31 @@
+#version 330 core
+layout (location=0) in vec3 pos;
+layout (location=1) in vec4 color;
+
+uniform mat4 model;
+//uniform mat4 view; //Grids are drawn like HUD.vert, so ignore the view matrix
+uniform mat4 projection;
+
+//Each instance is one grid line.  See mygl::Grid.
+uniform vec3 lineStart; //Position of the first line in model coordinates
+uniform vec3 lineStep; //Distance between lines in model coordinates
+uniform float fadeSpacing; //Lines closer together than this in NDC coordinates fade out
+
+out VS_OUT
+{
+  vec4 color;
+} vs_out;
+
+void main()
+{
+  vec3 offset = lineStart + float(gl_InstanceID)*lineStep;
+  gl_Position = projection*model*vec4(pos + offset, 1.0f);
+
+  //How far apart this line and the next one are on screen
+  vec4 here = projection*model*vec4(offset, 1.0f);
+  vec4 next = projection*model*vec4(offset + lineStep, 1.0f);
+  float spacing = length(next.xy/next.w - here.xy/here.w);
+
+  vs_out.color = color;
+  vs_out.color.a *= clamp(spacing/fadeSpacing, 0.0f, 1.0f);
+}
@@ -0,0 +1,21 @@
+#version 330 core
+layout (location=0) in vec3 pos;
+layout (location=1) in vec4 color;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+//Color of this placement of a shared mesh.  See MeshInstance.
+uniform vec4 instanceColor;
+
+out VS_OUT
+{
+  vec4 color;
+} vs_out;
+
+void main()
+{
+  gl_Position = projection*view*model*vec4(pos, 1.0f);
+  vs_out.color = instanceColor*color;
+}
@@ -1,10 +1,10 @@
 #version 330 core
-uniform vec4 idColor;
+uniform uint objectID;
 
-out vec4 color;
+out uint id;
 
 void main()
 {
-  color = idColor; //Provided by the user.  The user should be able to map this color back 
-                   //to a drawn object.  
+  id = objectID; //Provided by the user.  The user should be able to map this integer back 
+                 //to a drawn object.  Draw into a GL_R32UI framebuffer.
 }
@@ -55,6 +55,10 @@ namespace draw
                                                                                      
         //Clear the current queue of events because random access has happened
         virtual void Clear() = 0;
+
+        //Run only the drawing stage and return its' result instead of caching it for a Scene.  Doesn't 
+        //need RequestScene() or an OpenGL context, so benchmarks can call it without a window.
+        virtual std::unique_ptr<ctrl::SceneController::model_t> DrawModel(ARGS... args) = 0;
     };
 
     //A Controller implements ControllBase's interface by knowing the type of a DRAWER it 
@@ -108,6 +112,11 @@ namespace draw
           fModelCache = std::queue<std::unique_ptr<model_t>>();
         }
 
+        virtual std::unique_ptr<ctrl::SceneController::model_t> DrawModel(ARGS... args) override final
+        {
+          return fDrawer.doDraw(args...);
+        }
+
       private:
         scene_t* fScene; //Observer pointer to the SceneController that this Controller associates with its Drawer. 
                          //Holding a pointer is necessary to delay initialization.  
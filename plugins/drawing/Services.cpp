@@ -18,12 +18,19 @@
 
 namespace draw
 {
+  class EventView;
+  class TrajectoryTopology;
+
   struct Services
   {
     Services(): fPDGToColor(new mygl::PDGToColor()) {}
 
     std::unique_ptr<mygl::PDGToColor> fPDGToColor;
     std::unique_ptr<util::Geometry> fGeometry;
+
+    //Per-event indices built by the first plugin that needs them.  The application resets them before drawing a new event.
+    std::shared_ptr<const EventView> fEventView;
+    std::shared_ptr<const TrajectoryTopology> fTopology;
   };
 }
 
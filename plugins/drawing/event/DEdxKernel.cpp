@@ -0,0 +1,118 @@
+//File: DEdxKernel.cpp
+//Brief: Computes a material-corrected dE/dx for every TG4HitSegment in a sensitive detector at once.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//draw includes
+#include "DEdxKernel.h"
+
+//util includes
+#include "util/Geometry.cpp"
+
+//edepsim includes
+#include "TG4HitSegment.h"
+
+//ROOT includes
+#include "TGeoMaterial.h"
+
+//c++ includes
+#include <algorithm>
+
+namespace draw
+{
+  DEdxKernel::DEdxKernel(const size_t nSamples, const double minLength): fNSamples(std::max<size_t>(nSamples, 1)), 
+                                                                         fMinLength(minLength)
+  {
+  }
+
+  void DEdxKernel::operator ()(const std::vector<TG4HitSegment>& segments, util::Geometry& geo)
+  {
+    fSegments.clear();
+    fEnergy.clear();
+    fLength.clear();
+    fX.clear();
+    fY.clear();
+    fZ.clear();
+
+    //Sample points are at the centers of nSamples equal pieces of each segment
+    const double step = 1./fNSamples;
+    for(size_t which = 0; which < segments.size(); ++which)
+    {
+      const auto& edep = segments[which];
+      #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
+      const auto& start = edep.GetStart();
+      const auto& stop = edep.GetStop();
+      #else
+      const auto& start = edep.Start;
+      const auto& stop = edep.Stop;
+      #endif
+
+      const double dx = stop.X() - start.X(), dy = stop.Y() - start.Y(), dz = stop.Z() - start.Z();
+      if(dx*dx + dy*dy + dz*dz < fMinLength*fMinLength) continue;
+
+      fSegments.push_back(which);
+      #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
+      fEnergy.push_back(edep.GetEnergyDeposit());
+      fLength.push_back(edep.GetTrackLength());
+      #else
+      fEnergy.push_back(edep.EnergyDeposit);
+      fLength.push_back(edep.TrackLength);
+      #endif
+
+      for(size_t sample = 0; sample < fNSamples; ++sample)
+      {
+        const double frac = (sample + 0.5)*step;
+        fX.push_back(start.X() + dx*frac);
+        fY.push_back(start.Y() + dy*frac);
+        fZ.push_back(start.Z() + dz*frac);
+      }
+    }
+
+    fMaterials.resize(fX.size());
+    geo.FindMaterials(fX.data(), fY.data(), fZ.data(), fX.size(), fMaterials.data());
+
+    //Average material properties over each segment's samples.  Neighboring samples are usually in the same material.
+    const size_t nSegments = fSegments.size();
+    fSumDensity.assign(nSegments, 0.);
+    fSumA.assign(nSegments, 0.);
+    fSumZ.assign(nSegments, 0.);
+    const Properties* props = nullptr;
+    for(size_t segment = 0; segment < nSegments; ++segment)
+    {
+      for(size_t sample = segment*fNSamples; sample < (segment+1)*fNSamples; ++sample)
+      {
+        if(props == nullptr || props->fMaterial != fMaterials[sample]) props = &Lookup(fMaterials[sample]);
+        fSumDensity[segment] += props->fDensity;
+        fSumA[segment] += props->fA;
+        fSumZ[segment] += props->fZ;
+      }
+    }
+
+    //From http://pdg.lbl.gov/2011/reviews/rpp2011-rev-passage-particles-matter.pdf, the Bethe formula for dE/dx in 
+    //MeV*cm^2/g goes as Z/A.  To get comparable stopping powers for all materials, try to "remove the Z/A dependence".
+    //sumA/sumZ is the same as the ratio of the averages.  
+    const double densityUnits = 1./fNSamples/6.24e24*1e6;
+    fDEdx.resize(nSegments);
+    const double* energy = fEnergy.data();
+    const double* length = fLength.data();
+    const double* sumDensity = fSumDensity.data();
+    const double* sumA = fSumA.data();
+    const double* sumZ = fSumZ.data();
+    double* dEdx = fDEdx.data();
+    for(size_t segment = 0; segment < nSegments; ++segment)
+    {
+      const double value = energy[segment]/length[segment]*10./(sumDensity[segment]*densityUnits)*sumA[segment]/sumZ[segment];
+      dEdx[segment] = (length[segment] > 0.) ? value : 0.;
+    }
+  }
+
+  const DEdxKernel::Properties& DEdxKernel::Lookup(const TGeoMaterial* material)
+  {
+    //Detectors are made of a handful of materials, so a linear search wins over hashing
+    const auto found = std::find_if(fProperties.begin(), fProperties.end(), [material](const Properties& props) 
+                                                                            { return props.fMaterial == material; });
+    if(found != fProperties.end()) return *found;
+
+    fProperties.push_back({material, material->GetDensity(), material->GetA(), material->GetZ()});
+    return fProperties.back();
+  }
+}
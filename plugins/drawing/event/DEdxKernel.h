@@ -0,0 +1,76 @@
+//File: DEdxKernel.h
+//Brief: Computes a material-corrected dE/dx for every TG4HitSegment in a sensitive detector at once.  Each segment long 
+//       enough to draw is sampled at nSamples evenly spaced points along its length, all sample materials are looked 
+//       up with one batched util::Geometry::FindMaterials() call, and the density, A, and Z of each distinct material 
+//       are only read once.  The last pass over the segments works on plain arrays.  A DEdxKernel keeps its scratch 
+//       space between calls, so reuse one for every detector in an event.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//c++ includes
+#include <vector>
+#include <cstddef>
+
+#ifndef DRAW_DEDXKERNEL_H
+#define DRAW_DEDXKERNEL_H
+
+class TG4HitSegment;
+class TGeoMaterial;
+
+namespace util
+{
+  class Geometry;
+}
+
+namespace draw
+{
+  class DEdxKernel
+  {
+    public:
+      DEdxKernel(const size_t nSamples, const double minLength);
+
+      //Fills Segments() and DEdx() for segments.  
+      void operator ()(const std::vector<TG4HitSegment>& segments, util::Geometry& geo);
+
+      //Indices of the segments that are at least minLength long, in the order they were given
+      const std::vector<size_t>& Segments() const { return fSegments; }
+
+      //dE/dx of each segment in Segments() in MeV*cm^2/g, with the Z/A dependence of the Bethe formula divided out
+      const std::vector<double>& DEdx() const { return fDEdx; }
+
+      //Number of material lookups done by the last call
+      size_t NLookups() const { return fX.size(); }
+
+    private:
+      size_t fNSamples; //Material samples per segment
+      double fMinLength; //Segments shorter than this are skipped
+
+      //Per-segment data
+      std::vector<size_t> fSegments;
+      std::vector<double> fEnergy;
+      std::vector<double> fLength;
+      std::vector<double> fSumDensity;
+      std::vector<double> fSumA;
+      std::vector<double> fSumZ;
+      std::vector<double> fDEdx;
+
+      //Per-sample data
+      std::vector<double> fX;
+      std::vector<double> fY;
+      std::vector<double> fZ;
+      std::vector<const TGeoMaterial*> fMaterials;
+
+      //Density, A, and Z of each material seen so far
+      struct Properties
+      {
+        const TGeoMaterial* fMaterial;
+        double fDensity;
+        double fA;
+        double fZ;
+      };
+      std::vector<Properties> fProperties;
+
+      const Properties& Lookup(const TGeoMaterial* material);
+  };
+}
+
+#endif //DRAW_DEDXKERNEL_H
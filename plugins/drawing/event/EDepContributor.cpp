@@ -7,6 +7,7 @@
 
 //plugin includes
 #include "EDepContributor.h"
+#include "EventView.h"
 
 //gl includes
 #include "gl/model/Path.h"
@@ -40,14 +41,14 @@ namespace draw
     auto model = std::make_unique<legacy::model_t>(fEDepRecord);
     auto& scene = *model;
 
-    //Draw true energy deposits color-coded by dE/dx
-    auto edepToDet = data.SegmentDetectors; //A map from sensitive volume to energy deposition
+    const auto& view = EventView::Get(data, services);
 
-    for(auto& det: edepToDet)
+    //Draw true energy deposits color-coded by dE/dx
+    for(const auto& det: data.SegmentDetectors) //A map from sensitive volume to energy deposition
     {
-      auto detName = det.first;
+      const auto& detName = det.first;
       auto detRow = scene.emplace(fDefaultDraw);
-      auto edeps = det.second;
+      const auto& edeps = det.second;
 
       detRow[fEDepRecord->fPrimName] = detName;
       double sumE = 0., sumScintE = 0., minT = 1e10;
@@ -55,7 +56,7 @@ namespace draw
       //Produce a map of true trajectory to model_t::view
       std::map<int, legacy::model_t::view> idToIter;
 
-      for(auto& edep: edeps)
+      for(const auto& edep: edeps)
       {
         #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
         const auto start = edep.GetStart();
@@ -98,6 +99,8 @@ namespace draw
         #else
         const auto id = edep.PrimaryId;
         #endif
+        const auto primary = view.Trajectory(id);
+        if(primary == nullptr) continue; //Not saved in this event
         auto found = idToIter.find(id);
         if(found == idToIter.end())
         {
@@ -105,19 +108,19 @@ namespace draw
           auto row = found->second;
           row[fEDepRecord->fScintE] = 0;
           #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-          row[fEDepRecord->fEnergy] = data.Trajectories[id].GetInitialMomentum().E();
-          row[fEDepRecord->fdEdx] = data.Trajectories[id].GetInitialMomentum().E()/
-                                    (data.Trajectories[id].Points.front().GetPosition()
-                                     -data.Trajectories[id].Points.back().GetPosition()).Vect().Mag();
-          row[fEDepRecord->fT0] = data.Trajectories[id].Points.front().GetPosition().T();
-          row[fEDepRecord->fPrimName] = data.Trajectories[id].GetName();
+          row[fEDepRecord->fEnergy] = primary->GetInitialMomentum().E();
+          row[fEDepRecord->fdEdx] = primary->GetInitialMomentum().E()/
+                                    (primary->Points.front().GetPosition()
+                                     -primary->Points.back().GetPosition()).Vect().Mag();
+          row[fEDepRecord->fT0] = primary->Points.front().GetPosition().T();
+          row[fEDepRecord->fPrimName] = primary->GetName();
           #else
-          row[fEDepRecord->fEnergy] = data.Trajectories[id].InitialMomentum.E();
-          row[fEDepRecord->fdEdx] = data.Trajectories[id].InitialMomentum.E()/
-                                    (data.Trajectories[id].Points.front().Position
-                                     -data.Trajectories[id].Points.back().Position).Vect().Mag();
-          row[fEDepRecord->fT0] = data.Trajectories[id].Points.front().Position.T();
-          row[fEDepRecord->fPrimName] = data.Trajectories[id].Name;
+          row[fEDepRecord->fEnergy] = primary->InitialMomentum.E();
+          row[fEDepRecord->fdEdx] = primary->InitialMomentum.E()/
+                                    (primary->Points.front().Position
+                                     -primary->Points.back().Position).Vect().Mag();
+          row[fEDepRecord->fT0] = primary->Points.front().Position.T();
+          row[fEDepRecord->fPrimName] = primary->Name;
           #endif
         }
         auto parent = found->second;
@@ -137,9 +140,9 @@ namespace draw
         double dEdx = energy/length;
 
         #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-        const auto pdg = data.Trajectories[id].GetPDGCode();
+        const auto pdg = primary->GetPDGCode();
         #else
-        const auto pdg = data.Trajectories[id].PDGCode;
+        const auto pdg = primary->PDGCode;
         #endif
 
         auto row = parent.emplace<mygl::Path>(true, glm::mat4(), std::vector<glm::vec3>{firstPos, lastPos}, 
@@ -156,9 +159,9 @@ namespace draw
         row[fEDepRecord->fdEdx]    = dEdx;
         row[fEDepRecord->fT0]      = start.T();
         #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-        row[fEDepRecord->fPrimName] = data.Trajectories[id].GetName(); //TODO: energy depositions children of contributing tracks?
+        row[fEDepRecord->fPrimName] = primary->GetName(); //TODO: energy depositions children of contributing tracks?
         #else
-        row[fEDepRecord->fPrimName] = data.Trajectories[id].Name;
+        row[fEDepRecord->fPrimName] = primary->Name;
         #endif
 
         sumE += energy;
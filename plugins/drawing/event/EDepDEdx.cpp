@@ -7,6 +7,8 @@
 
 //plugin includes
 #include "EDepDEdx.h"
+#include "EventView.h"
+#include "DEdxKernel.h"
 
 //gl includes
 #include "gl/model/Path.h"
@@ -15,11 +17,16 @@
 //edepsim includes
 #include "TG4Event.h"
 
+//c++ includes
+#include <chrono>
+#include <iostream>
+
 namespace draw
 {
   EDepDEdx::EDepDEdx(const YAML::Node& config): fPalette(config["dEdxScale"]["min"].as<float>(), 
                                                          config["dEdxScale"]["max"].as<float>()), 
-                                                fLineWidth(0.008), fMinLength(1.0), fDefaultDraw(true),
+                                                fLineWidth(0.008), fMinLength(1.0), fNSamples(10), fReportTiming(false), 
+                                                fDefaultDraw(true),
                                                 fEDepRecord(new EDepRecord())
   {
     /*auto dEdxScale = std::make_pair(0.f, 8.f);
@@ -32,6 +39,8 @@ namespace draw
 
     if(config["LineWidth"]) fLineWidth = config["LineWidth"].as<float>();
     if(config["MinLength"]) fMinLength = config["MinLength"].as<float>();    
+    if(config["NSamples"]) fNSamples = config["NSamples"].as<size_t>();
+    if(config["ReportTiming"]) fReportTiming = config["ReportTiming"].as<bool>();
     if(config["DefaultDraw"]) fDefaultDraw = config["DefaultDraw"].as<bool>();
   }
   
@@ -47,14 +56,21 @@ namespace draw
     auto model = std::make_unique<legacy::model_t>(fEDepRecord);
     auto& scene = *model;
 
-    //Draw true energy deposits color-coded by dE/dx
-    auto edepToDet = data.SegmentDetectors; //A map from sensitive volume to energy deposition
+    const auto& view = EventView::Get(data, services);
+
+    //Get the weighted density of the material that most of each energy deposit was deposited in.  Increase the accuracy of 
+    //this material guess by increasing the number of sample points, but beware of event loading time!  Turn on ReportTiming 
+    //to see how long that takes.  
+    DEdxKernel kernel(fNSamples, fMinLength);
+    std::chrono::duration<double, std::milli> kernelTime(0);
+    size_t nSegments = 0, nLookups = 0;
 
-    for(auto& det: edepToDet)
+    //Draw true energy deposits color-coded by dE/dx
+    for(const auto& det: data.SegmentDetectors) //A map from sensitive volume to energy deposition
     {
-      auto detName = det.first;
+      const auto& detName = det.first;
       auto detRow = scene.emplace(fDefaultDraw);
-      auto edeps = det.second;
+      const auto& edeps = det.second;
 
       detRow[fEDepRecord->fPrimName] = detName;
       //TODO: Map sensitive volume name to detector name and use same VisID?  This would seem to require infrastructure that 
@@ -83,56 +99,27 @@ namespace draw
       }
       Palette palette(std::log10(mindEdx), std::log10(maxdEdx));*/
                                                                                                                                                                                        
-      for(auto& edep: edeps)
+      const auto kernelStart = std::chrono::steady_clock::now();
+      kernel(edeps, *services.fGeometry);
+      kernelTime += std::chrono::steady_clock::now() - kernelStart;
+      nSegments += kernel.Segments().size();
+      nLookups += kernel.NLookups();
+
+      for(size_t drawn = 0; drawn < kernel.Segments().size(); ++drawn)
       {
+        const auto& edep = edeps[kernel.Segments()[drawn]];
         #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
         const auto start = edep.GetStart();
         const auto stop = edep.GetStop();
+        const double energy = edep.GetEnergyDeposit();
         #else
         const auto start = edep.Start;
         const auto stop = edep.Stop;
+        const double energy = edep.EnergyDeposit;
         #endif
         glm::vec3 firstPos(start.X(), start.Y(), start.Z());
-
-        if((start-stop).Vect().Mag() < fMinLength) continue;
-          
-        //Get the density of material at the middle of this energy deposit
-        /*const auto diff = start.Vect()-stop.Vect();
-        const auto mid = start.Vect()+diff.Unit()*diff.Mag();
-        const double density = mat->GetDensity()/6.24e24*1e6;*/
-
-        //Get the weighted density of the material that most of this energy deposit was deposited in.  Increase the accuracy of this 
-        //material guess by increasing the number of sample points, but beware of event loading time!
-        const size_t nSamples = 10;
-        const auto diff = start.Vect()-stop.Vect();
-        const double dist = diff.Mag();
-        double sumDensity = 0;
-        double sumA = 0;
-        double sumZ = 0;   
-        for(size_t sample = 0; sample < nSamples; ++sample)
-        {
-          const auto pos = start.Vect()+diff.Unit()*dist;
-          const auto& mat = services.fGeometry->FindMaterial(pos); 
-          sumDensity += mat.GetDensity();
-          sumA += mat.GetA();
-          sumZ += mat.GetZ();
-        }
-        const double density = sumDensity/nSamples/6.24e24*1e6;
-        //std::cout << "density is " << density << "\n";
-  
         glm::vec3 lastPos(stop.X(), stop.Y(), stop.Z());
-
-        #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-        const double energy = edep.GetEnergyDeposit();
-        const double length = edep.GetTrackLength();
-        #else
-        const double energy = edep.EnergyDeposit;
-        const double length = edep.TrackLength;
-        #endif
-        double dEdx = 0.;
-        //From http://pdg.lbl.gov/2011/reviews/rpp2011-rev-passage-particles-matter.pdf, the Bethe formula for dE/dx in 
-        //MeV*cm^2/g goes as Z/A.  To get comparable stopping powers for all materials, try to "remove the Z/A dependence".
-        if(length > 0.) dEdx = energy/length*10./density*sumA/sumZ; //*mat->GetA()/mat->GetZ(); 
+        const double dEdx = kernel.DEdx()[drawn];
 
         //TODO: Consider getting energy from total deposit, dE/dx, and primary contributor?
         /*const double eMin = 0., eMax = 1.;
@@ -145,6 +132,8 @@ namespace draw
         #else
         const auto id = edep.PrimaryId;
         #endif
+        const auto primary = view.Trajectory(id);
+        if(primary == nullptr) continue; //Not saved in this event
 
         auto found = idToIter.find(id);
         if(found == idToIter.end())
@@ -153,19 +142,19 @@ namespace draw
           auto row = found->second;
           row[fEDepRecord->fScintE] = 0;
           #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-          row[fEDepRecord->fEnergy] = data.Trajectories[id].GetInitialMomentum().E();
-          row[fEDepRecord->fdEdx] = data.Trajectories[id].GetInitialMomentum().E()/
-                                    (data.Trajectories[id].Points.front().GetPosition()
-                                     -data.Trajectories[id].Points.back().GetPosition()).Vect().Mag();
-          row[fEDepRecord->fT0] = data.Trajectories[id].Points.front().GetPosition().T();
-          row[fEDepRecord->fPrimName] = data.Trajectories[id].GetName();
+          row[fEDepRecord->fEnergy] = primary->GetInitialMomentum().E();
+          row[fEDepRecord->fdEdx] = primary->GetInitialMomentum().E()/
+                                    (primary->Points.front().GetPosition()
+                                     -primary->Points.back().GetPosition()).Vect().Mag();
+          row[fEDepRecord->fT0] = primary->Points.front().GetPosition().T();
+          row[fEDepRecord->fPrimName] = primary->GetName();
           #else
-          row[fEDepRecord->fEnergy] = data.Trajectories[id].InitialMomentum.E();
-          row[fEDepRecord->fdEdx] = data.Trajectories[id].InitialMomentum.E()/
-                                    (data.Trajectories[id].Points.front().Position
-                                     -data.Trajectories[id].Points.back().Position).Vect().Mag();
-          row[fEDepRecord->fT0] = data.Trajectories[id].Points.front().Position.T();
-          row[fEDepRecord->fPrimName] = data.Trajectories[id].Name;
+          row[fEDepRecord->fEnergy] = primary->InitialMomentum.E();
+          row[fEDepRecord->fdEdx] = primary->InitialMomentum.E()/
+                                    (primary->Points.front().Position
+                                     -primary->Points.back().Position).Vect().Mag();
+          row[fEDepRecord->fT0] = primary->Points.front().Position.T();
+          row[fEDepRecord->fPrimName] = primary->Name;
           #endif
         }
 
@@ -188,9 +177,9 @@ namespace draw
         row[fEDepRecord->fdEdx]    = dEdx;
         row[fEDepRecord->fT0]      = start.T();
         #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-        row[fEDepRecord->fPrimName] = data.Trajectories[id].GetName(); //TODO: energy depositions children of contributing tracks?
+        row[fEDepRecord->fPrimName] = primary->GetName(); //TODO: energy depositions children of contributing tracks?
         #else
-        row[fEDepRecord->fPrimName] = data.Trajectories[id].Name;
+        row[fEDepRecord->fPrimName] = primary->Name;
         #endif
 
         //(*parent)[fEDepRecord->fScintE] += edep.SecondaryDeposit;
@@ -200,6 +189,12 @@ namespace draw
         if(start.T() < minT) minT = start.T();
       }
     }
+
+    if(fReportTiming)
+    {
+      std::cout << "EDepDEdx: dE/dx for " << nSegments << " segments with " << fNSamples << " samples each (" << nLookups 
+                << " material lookups) took " << kernelTime.count() << " ms\n";
+    }
     return model;
   }
 
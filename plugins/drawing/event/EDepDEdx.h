@@ -32,6 +32,8 @@ namespace draw
       mygl::Palette fPalette; //Mapping from dE/dx to color
       float fLineWidth; //The width of lines to be drawn for energy deposits
       float fMinLength; //Hit segments with length less than this value will not be drawn
+      size_t fNSamples; //Number of points along each hit segment where material is sampled for dE/dx
+      bool fReportTiming; //Print how long dE/dx took for each event?
       bool fDefaultDraw; //Draw this Scene by default?
 
       class EDepRecord: public ctrl::ColumnModel
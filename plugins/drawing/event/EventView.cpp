@@ -0,0 +1,92 @@
+//File: EventView.cpp
+//Brief: An EventView indexes a TG4Event by track ID and by parent ID without copying any trajectories.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//draw includes
+#include "EventView.h"
+
+//edepsim includes
+#include "TG4Event.h"
+
+//c++ includes
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+  int TrackID(const TG4Trajectory& traj)
+  {
+    #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
+    return traj.GetTrackId();
+    #else
+    return traj.TrackId;
+    #endif
+  }
+
+  int ParentID(const TG4Trajectory& traj)
+  {
+    #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
+    return traj.GetParentId();
+    #else
+    return traj.ParentId;
+    #endif
+  }
+}
+
+namespace draw
+{
+  EventView::EventView(const TG4Event& evt): fEvent(evt)
+  {
+    const auto& trajs = evt.Trajectories;
+
+    int maxID = -1;
+    for(const auto& traj: trajs) maxID = std::max(maxID, TrackID(traj));
+
+    fByTrackID.assign(maxID+1, nullptr);
+    for(const auto& traj: trajs)
+    {
+      if(TrackID(traj) >= 0) fByTrackID[TrackID(traj)] = &traj;
+    }
+
+    //Counting sort by parent ID keeps siblings in event order.  Parents that can't be the ID of any trajectory in this 
+    //event, except -1 for primaries, are left out.  
+    fParentBegin.assign(maxID+3, 0);
+    for(const auto& traj: trajs)
+    {
+      const int parent = ParentID(traj);
+      if(parent >= -1 && parent <= maxID) ++fParentBegin[parent+2];
+    }
+    std::partial_sum(fParentBegin.begin(), fParentBegin.end(), fParentBegin.begin());
+
+    fByParent.resize(fParentBegin.back());
+    auto next = fParentBegin;
+    for(const auto& traj: trajs)
+    {
+      const int parent = ParentID(traj);
+      if(parent >= -1 && parent <= maxID) fByParent[next[parent+1]++] = &traj;
+    }
+  }
+
+  const TG4Trajectory* EventView::Trajectory(const int trackID) const
+  {
+    if(trackID < 0 || trackID >= (int)fByTrackID.size()) return nullptr;
+    return fByTrackID[trackID];
+  }
+
+  EventView::trajs_t EventView::Children(const int parentID) const
+  {
+    if(parentID < -1 || parentID+2 >= (int)fParentBegin.size()) return trajs_t();
+    return trajs_t(fByParent.data() + fParentBegin[parentID+1], fByParent.data() + fParentBegin[parentID+2]);
+  }
+
+  Span<const TG4TrajectoryPoint> EventView::Points(const TG4Trajectory& traj)
+  {
+    return Span<const TG4TrajectoryPoint>(traj.Points.data(), traj.Points.data() + traj.Points.size());
+  }
+
+  const EventView& EventView::Get(const TG4Event& evt, Services& services)
+  {
+    if(!services.fEventView) services.fEventView = std::make_shared<EventView>(evt);
+    return *services.fEventView;
+  }
+}
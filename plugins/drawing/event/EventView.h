@@ -0,0 +1,80 @@
+//File: EventView.h
+//Brief: An EventView indexes a TG4Event by track ID and by parent ID without copying any trajectories.  It hands out 
+//       Spans, which point into the TG4Event or into EventView's own tables, so plugins can walk the trajectory tree 
+//       and each trajectory's points without allocating.  An EventView is only valid as long as the TG4Event it was 
+//       made from.  Every plugin drawing the same event shares one EventView through Services.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//plugin includes
+#include "plugins/drawing/Services.cpp"
+
+//c++ includes
+#include <vector>
+#include <cstddef>
+
+#ifndef DRAW_EVENTVIEW_H
+#define DRAW_EVENTVIEW_H
+
+class TG4Event;
+class TG4Trajectory;
+class TG4TrajectoryPoint;
+
+namespace draw
+{
+  //A contiguous range of T that someone else owns
+  template <class T>
+  class Span
+  {
+    public:
+      Span(): fBegin(nullptr), fEnd(nullptr) {}
+      Span(T* begin, T* end): fBegin(begin), fEnd(end) {}
+
+      T* begin() const { return fBegin; }
+      T* end() const { return fEnd; }
+      size_t size() const { return fEnd - fBegin; }
+      bool empty() const { return fBegin == fEnd; }
+
+      T& operator [](const size_t index) const { return fBegin[index]; }
+      T& front() const { return *fBegin; }
+      T& back() const { return *(fEnd - 1); }
+
+    private:
+      T* fBegin;
+      T* fEnd;
+  };
+
+  class EventView
+  {
+    public:
+      using trajs_t = Span<const TG4Trajectory* const>;
+
+      EventView(const TG4Event& evt);
+
+      const TG4Event& Event() const { return fEvent; }
+
+      //nullptr if there is no trajectory with trackID in this event
+      const TG4Trajectory* Trajectory(const int trackID) const;
+
+      //Trajectories whose parent is parentID in the order they appear in the event
+      trajs_t Children(const int parentID) const;
+
+      //Trajectories with no parent
+      trajs_t Primaries() const { return Children(-1); }
+
+      //traj's points without copying them
+      static Span<const TG4TrajectoryPoint> Points(const TG4Trajectory& traj);
+
+      //The EventView for evt.  It is only built by the first plugin to ask for it after the application resets 
+      //services.fEventView for a new event.
+      static const EventView& Get(const TG4Event& evt, Services& services);
+
+    private:
+      const TG4Event& fEvent;
+      std::vector<const TG4Trajectory*> fByTrackID; //Trajectory for each track ID.  edep-sim's track IDs count up from 0.
+      std::vector<const TG4Trajectory*> fByParent; //Trajectories grouped by parent ID in event order
+      std::vector<size_t> fParentBegin; //Where parent ID i's children start in fByParent is fParentBegin[i+1].  The extra 
+                                        //entry at the end means they stop at fParentBegin[i+2].
+  };
+}
+
+#endif //DRAW_EVENTVIEW_H
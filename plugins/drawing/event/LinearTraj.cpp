@@ -4,6 +4,8 @@
 
 //draw includes
 #include "LinearTraj.h"
+#include "EventView.h"
+#include "TrajectoryTopology.h"
 
 //gl includes
 #include "gl/model/Path.h"
@@ -11,11 +13,9 @@
 //edepsim includes
 #include "TG4Event.h" 
 
-//ROOT includes
-#include "TDatabasePDG.h"
-
-//c++ includes
-#include <regex>
+//util includes
+#include "util/GenieReaction.h"
+#include "util/PDGNames.h"
 
 namespace draw
 {
@@ -36,69 +36,45 @@ namespace draw
     auto model = std::make_unique<legacy::model_t>(fTrajRecord);
     auto& trajScene = *model;
 
-    //Next, make maps of trackID to particle and parent ID to particle
-    std::map<int, std::vector<TG4Trajectory>> parentID;
-    for(auto& traj: evt.Trajectories)
-    {
-      #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-      parentID[traj.GetParentId()].push_back(traj);
-      #else
-      parentID[traj.ParentId].push_back(traj);
-      #endif
-    }
+    //Next, find out which trajectories are children of which
+    const auto& view = EventView::Get(evt, services);
+    const auto& topology = TrajectoryTopology::Get(evt, services);
 
     //Then, add particles to list tree and viewer
-    std::regex genieToEvd(R"(nu:(-?[[:digit:]]+);tgt:([[:digit:]]+);N:([[:digit:]]+)(.*);proc:Weak\[([[:alpha:]]+)\],([[:alpha:]]+);(.*))");
     auto& primaries = evt.Primaries;
     for(auto& prim: primaries)
     {
       auto row = trajScene.emplace(fDefaultDraw);
         
       //Turn GENIE's interaction string into something easier to read
-      std::smatch match;
-      std::string nu;
-      //int pdg;
-       
       #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-      const std::string reaction = prim.GetReaction();
+      const std::string& reaction = prim.GetReaction();
       #else
-      const std::string reaction = prim.Reaction;
+      const std::string& reaction = prim.Reaction;
       #endif
-      if(std::regex_match(reaction, match, genieToEvd)) 
-      {
-
-        const std::string nu = TDatabasePDG::Instance()->GetParticle(std::stoi(match[1].str()))->GetName();
-        //const std::string nucleus = fPdgDB.GetParticle(match[2].str().c_str())->GetName(); //TODO: TDatabasPDG can't read PDG codes for nuclei
-
-        /*const auto particle = TDatabasePDG::Instance()->GetParticle(std::stoi(match[3].str()));
-        if(particle)
-        {
-          const std::string nucleon = particle->GetName(); 
-        }*/
 
-        //Add this interaction vertex to the scene of trajectory points
-        //pdg = std::stoi(match[1].str());
+      util::GenieReaction genie;
+      if(util::ParseGenieReaction(reaction, genie)) 
+      {
+        //TODO: TDatabasPDG can't read PDG codes for nuclei, so genie.fTargetPDG isn't used.  
+        row[fTrajRecord->fPartName] = util::PDGName(genie.fNuPDG)+" "+genie.fCurrent.str()+" "+genie.fProcess.str();
       }
       else
       {
         std::cerr << "WARNING: Got interaction string from GENIE that does not match what I expect:\n"
                   << reaction << "\n";
-        nu = reaction;
-        //pdg = 0; //Supposed to be a "Geantino" to indicate that something is wrong
+        row[fTrajRecord->fPartName] = reaction;
       }
-
-      row[fTrajRecord->fPartName] = nu+" "+match[5].str()+" "+match[6].str();//+" on "/*+nucleus+" "*/+nucleon;
       row[fTrajRecord->fEnergy] = -1; //TODO: Get this from updated TG4PrimaryVertex?
 
-      const auto& children = parentID[-1];
-      for(const auto& child: children) AppendTrajectory(row, child, parentID, services);
+      for(const auto child: view.Primaries()) AppendTrajectory(row, *child, topology, services);
     }
     return model;
   }
 
   //Helper functions for drawing trajectories and trajectory points
   void LinearTraj::AppendTrajectory(legacy::model_t::view& parent, const TG4Trajectory& traj, 
-                                    std::map<int, std::vector<TG4Trajectory>>& parentToTraj, Services& services)
+                                    const TrajectoryTopology& topology, Services& services)
   {
     #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
     const int pdg = traj.GetPDGCode();
@@ -107,49 +83,40 @@ namespace draw
     #endif
     const auto color = (*(services.fPDGToColor))[pdg];
 
-    auto points = traj.Points;
-    std::vector<glm::vec3> vertices;
-    for(auto pointIt = points.begin(); pointIt != points.end(); ++pointIt)
+    const auto points = EventView::Points(traj);
+
+    //Test all of this trajectory's points against the fiducial volume at once
+    const size_t nPoints = points.size();
+    std::vector<double> x(nPoints), y(nPoints), z(nPoints);
+    for(size_t whichPoint = 0; whichPoint < nPoints; ++whichPoint)
     {
-      auto& point = *pointIt;
       #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-      const auto pos = point.GetPosition();
+      const auto& pos = points[whichPoint].GetPosition();
       #else
-      const auto pos = point.Position;
+      const auto& pos = points[whichPoint].Position;
       #endif
+      x[whichPoint] = pos.X();
+      y[whichPoint] = pos.Y();
+      z[whichPoint] = pos.Z();
+    }
+    std::vector<unsigned char> fiducial(nPoints);
+    services.fGeometry->IsFiducial(x.data(), y.data(), z.data(), nPoints, fiducial.data());
 
+    std::vector<glm::vec3> vertices;
+    for(size_t whichPoint = 0; whichPoint < nPoints; ++whichPoint)
+    {
       //Require that point is inside fiducial volume
-      if(services.fGeometry->IsFiducial(pos.Vect()))
+      if(fiducial[whichPoint])
       {
-        vertices.emplace_back(pos.X(), pos.Y(), pos.Z());
+        vertices.emplace_back(x[whichPoint], y[whichPoint], z[whichPoint]);
       }
-      else if(pointIt != points.begin()) //Extrapolate to the face of the fiducial volume
+      else if(whichPoint > 0 && fiducial[whichPoint-1]) //Extrapolate to the face of the fiducial volume from the previous point 
       {
-        #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-        const auto prevPoint = (pointIt-1)->GetPosition();
-        #else
-        const auto prevPoint = (pointIt-1)->Position;
-        #endif
-
-        //Make sure previous point was in the fiducial volume
-        if(services.fGeometry->IsFiducial(prevPoint.Vect()))
-        {
-          //TGeoShape::DistFromInside needs two 3-vectors in the local frame:
-          //The direction
-          const auto dirLocalV = services.fGeometry->InLocal((pos-prevPoint).Vect().Unit());
-          double dirLocal[] = {dirLocalV.X(), dirLocalV.Y(), dirLocalV.Z()};
-
-          //The position inside the volume
-          const auto prevLocal = services.fGeometry->InLocal(prevPoint.Vect());          
-          double local[] = {prevLocal.X(), prevLocal.Y(), prevLocal.Z()};
-
-          const auto dist = services.fGeometry->GetFiducial().GetVolume()->GetShape()->DistFromInside(local, dirLocal, 3); 
-
-          //Now, convert the position of the point to draw back to the master frame in which everything is drawn          
-          const auto master = services.fGeometry->InMaster(TVector3(local[0]+dirLocal[0]*dist, local[1]+dirLocal[1]*dist, 
-                                                                    local[2]+dirLocal[2]*dist));
-          vertices.emplace_back(master.X(), master.Y(), master.Z());
-        }
+        const TVector3 pos(x[whichPoint], y[whichPoint], z[whichPoint]), prevPoint(x[whichPoint-1], y[whichPoint-1], z[whichPoint-1]);
+        const auto dir = (pos-prevPoint).Unit();
+        const auto dist = services.fGeometry->DistToFiducialBoundary(prevPoint, dir);
+        const auto master = prevPoint + dist*dir;
+        vertices.emplace_back(master.X(), master.Y(), master.Z());
       }
     }
 
@@ -167,38 +134,13 @@ namespace draw
                                                                        //calculate 0...
     row[fTrajRecord->fEnergy] = p.E()-invariantMass; //Kinetic energy
 
-    //Second pass over trajectory points to find starting points of children.
+    //Children are drawn in the order of the points they start from
     #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-    auto children = parentToTraj[traj.GetTrackId()];
+    const auto& children = topology.Children(traj.GetTrackId());
     #else
-    auto children = parentToTraj[traj.TrackId];
+    const auto& children = topology.Children(traj.TrackId);
     #endif
-
-    //Produce map of closest trajectory point to child trajectory
-    std::map<std::vector<TG4TrajectoryPoint>::iterator, std::vector<TG4Trajectory>> ptToTraj;
-    for(const auto& child: children)
-    {
-      ptToTraj[std::min_element(points.begin(), points.end(), [&child](const TG4TrajectoryPoint& first, 
-                                                                       const TG4TrajectoryPoint& second)
-                                                              {
-                                                                #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-                                                                return (first.GetPosition() - child.Points.front().GetPosition()).Mag() < 
-                                                                       (second.GetPosition() - child.Points.front().GetPosition()).Mag();
-                                                                #else
-                                                                return (first.Position - child.Points.front().Position).Mag() <
-                                                                       (second.Position - child.Points.front().Position).Mag();
-                                                                #endif
-                                                              })].push_back(child);
-    } 
-      
-    for(auto ptIt = points.begin(); ptIt != points.end(); ++ptIt)
-    {
-      const auto& subChildren = ptToTraj[ptIt];
-      for(const auto& child: subChildren)
-      {
-        AppendTrajectory(row, child, parentToTraj, services);
-      }
-    }
+    for(const auto& child: children) AppendTrajectory(row, *child.fTraj, topology, services);
   }
 
   REGISTER_EVENT(LinearTraj);
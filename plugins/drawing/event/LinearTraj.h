@@ -16,6 +16,8 @@ class TG4TrajectoryPoint;
 
 namespace draw
 {
+  class TrajectoryTopology;
+
   class LinearTraj
   {
     public:
@@ -33,7 +35,7 @@ namespace draw
 
       //Helper functions for drawing trajectories and trajectory points
       void AppendTrajectory(legacy::model_t::view& parent, const TG4Trajectory& traj, 
-                            std::map<int, std::vector<TG4Trajectory>>& parentToTraj, Services& services);
+                            const TrajectoryTopology& topology, Services& services);
 
       //Description of the data saved for a trajectory
       class TrajRecord: public ctrl::ColumnModel
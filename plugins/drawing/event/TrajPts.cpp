@@ -4,6 +4,8 @@
 
 //draw includes
 #include "TrajPts.h"
+#include "EventView.h"
+#include "TrajectoryTopology.h"
 
 //gl includes
 #include "gl/model/Path.h"
@@ -12,8 +14,9 @@
 //plugin factory for macro
 #include "plugins/Factory.cpp"
 
-//ROOT includes
-#include "TDatabasePDG.h"
+//util includes
+#include "util/GenieReaction.h"
+#include "util/PDGNames.h"
 
 //edepsim includes
 #include "TG4Event.h" 
@@ -21,9 +24,6 @@
 //tinyxml2 include for configuration
 #include <tinyxml2.h>
 
-//c++ includes
-#include <regex>
-
 namespace
 {
   //TODO: This function seems generally useful for working with edepsim.  Move it to its' own file.
@@ -97,41 +97,30 @@ namespace draw
     auto model = std::make_unique<legacy::model_t>(fTrajPtRecord);
     auto& ptScene = *model;
 
-    //Next, make maps of trackID to particle and parent ID to particle
-    std::map<int, std::vector<TG4Trajectory>> parentID;
-    for(auto& traj: evt.Trajectories)
-    {
-      #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-      parentID[traj.GetParentId()].push_back(traj);
-      #else
-      parentID[traj.ParentId].push_back(traj);
-      #endif
-    }
+    //Next, find out which trajectories are children of which
+    const auto& view = EventView::Get(evt, services);
+    const auto& topology = TrajectoryTopology::Get(evt, services);
 
     //Then, add particles to list tree and viewer
-    std::regex genieToEvd(R"(nu:(-?[[:digit:]]+);tgt:([[:digit:]]+);N:([[:digit:]]+)(.*);proc:Weak\[([[:alpha:]]+)\],([[:alpha:]]+);(.*))");
     auto& primaries = evt.Primaries;
     for(auto& prim: primaries)
     {
       //Turn GENIE's interaction string into something easier to read
-      std::smatch match;
       #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-      const std::string reaction = prim.GetReaction();
+      const std::string& reaction = prim.GetReaction();
       #else
-      const std::string reaction = prim.Reaction;
+      const std::string& reaction = prim.Reaction;
       #endif
       
-      if(!std::regex_match(reaction, match, genieToEvd)) std::cerr << "Got interaction string from GENIE that does not match what I expect:\n"
-                                                                   << reaction << "\n";
-
-      const std::string nu = TDatabasePDG::Instance()->GetParticle(std::stoi(match[1].str()))->GetName();
-      //const std::string nucleus = fPdgDB.GetParticle(match[2].str().c_str())->GetName(); //TODO: TDatabasPDG can't read PDG codes for nuclei
-
-      /*const auto particle = TDatabasePDG::Instance()->GetParticle(std::stoi(match[3].str()));
-      if(particle)
+      util::GenieReaction genie;
+      if(!util::ParseGenieReaction(reaction, genie)) 
       {
-        const std::string nucleon = particle->GetName(); 
-      }*/
+        std::cerr << "Got interaction string from GENIE that does not match what I expect:\n" << reaction << "\n";
+        genie = util::GenieReaction();
+      }
+
+      const std::string& nu = util::PDGName(genie.fNuPDG);
+      //TODO: TDatabasPDG can't read PDG codes for nuclei, so genie.fTargetPDG isn't used.  
 
       //Add this interaction vertex to the scene of trajectory points
       #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
@@ -139,7 +128,7 @@ namespace draw
       #else
       const auto ptPos = prim.Position;
       #endif
-      const int pdg = std::stoi(match[1].str());
+      const int pdg = genie.fNuPDG;
       const auto color = (*(services.fPDGToColor))[pdg];
 
       //TODO: Function in Scene/Viewer to add a new Drawable with a new top-level TreeRow
@@ -147,18 +136,17 @@ namespace draw
                                                                       ptPos.Y(), ptPos.Z()), glm::vec4(color, 1.0), fPointRad);
       ptRow[fTrajPtRecord->fMomMag] = -1.; //TODO: Get primary momentum
       ptRow[fTrajPtRecord->fTime] = ptPos.T();
-      ptRow[fTrajPtRecord->fProcess] = nu+" "+match[5].str()+" "+match[6].str();
+      ptRow[fTrajPtRecord->fProcess] = nu+" "+genie.fCurrent.str()+" "+genie.fProcess.str();
       ptRow[fTrajPtRecord->fParticle] = nu;
 
-      const auto& children = parentID[-1];
-      for(const auto& child: children) AppendTrajPts(ptRow, child, parentID, services);
+      for(const auto child: view.Primaries()) AppendTrajPts(ptRow, *child, topology, services);
     }
     return model;
   }
 
   //Helper functions for drawing trajectories and trajectory points
   void TrajPts::AppendTrajPts(legacy::model_t::view& parent, const TG4Trajectory& traj, 
-                              std::map<int, std::vector<TG4Trajectory>>& parentToTraj, Services& services)
+                              const TrajectoryTopology& topology, Services& services)
   {
     #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
     const int pdg = traj.GetPDGCode();
@@ -166,46 +154,28 @@ namespace draw
     const int pdg = traj.PDGCode;
     #endif
     const auto color = (*(services.fPDGToColor))[pdg];
-    auto points = traj.Points;
+    const auto points = EventView::Points(traj);
 
-    //Second pass over trajectory points to find starting points of children.
+    //Children are sorted by the point they start closest to
     #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-    const auto id = traj.GetTrackId();
+    const auto& children = topology.Children(traj.GetTrackId());
     #else
-    const auto id = traj.TrackId;
+    const auto& children = topology.Children(traj.TrackId);
     #endif
-    auto children = parentToTraj[id];
-
-    //Produce map of closest trajectory point to child trajectory
-    std::map<std::vector<TG4TrajectoryPoint>::iterator, std::vector<TG4Trajectory>> ptToTraj;
-    for(const auto& child: children)
-    {
-      ptToTraj[std::min_element(points.begin(), points.end(), [&child](const TG4TrajectoryPoint& first, 
-                                                                       const TG4TrajectoryPoint& second)
-                                                              {
-                                                                #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-                                                                return (first.GetPosition() - child.Points.front().GetPosition()).Mag() < 
-                                                                       (second.GetPosition() - child.Points.front().GetPosition()).Mag();
-                                                                #else
-                                                                return (first.Position - child.Points.front().Position).Mag() <
-                                                                       (second.Position - child.Points.front().Position).Mag();
-                                                                #endif
-                                                              })].push_back(child);
-    } 
+    auto child = children.begin();
       
-    for(auto ptIt = points.begin(); ptIt != points.end(); ++ptIt)
+    for(size_t whichPoint = 0; whichPoint < points.size(); ++whichPoint)
     {
-      const auto& point = *ptIt;
+      const auto& point = points[whichPoint];
       #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
       const std::string name = traj.GetName();
       #else
       const std::string name = traj.Name;
       #endif
       auto ptRow = AddTrajPt(parent, name, point, glm::vec4(color, 1.0));
-      const auto& subChildren = ptToTraj[ptIt];
-      for(const auto& child: subChildren)
+      for(; child != children.end() && child->fPoint == whichPoint; ++child)
       {
-        AppendTrajPts(ptRow, child, parentToTraj, services);
+        AppendTrajPts(ptRow, *child->fTraj, topology, services);
       }
     }
   }
@@ -18,6 +18,8 @@ class TG4TrajectoryPoint;
 
 namespace draw
 {
+  class TrajectoryTopology;
+
   class TrajPts
   {
     public:
@@ -35,7 +37,7 @@ namespace draw
 
       //Helper functions for drawing trajectories and trajectory points
       void AppendTrajPts(legacy::model_t::view& parent, const TG4Trajectory& traj,
-                         std::map<int, std::vector<TG4Trajectory>>& parentToTraj, Services& services);
+                         const TrajectoryTopology& topology, Services& services);
 
       legacy::model_t::view AddTrajPt(legacy::model_t::view& parent, const std::string& particle, 
                                       const TG4TrajectoryPoint& pt, const glm::vec4& color);
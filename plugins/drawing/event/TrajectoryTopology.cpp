@@ -0,0 +1,181 @@
+//File: TrajectoryTopology.cpp
+//Brief: Works out once per event which point on its parent each TG4Trajectory starts closest to so that trajectory 
+//       plugins can draw children under the right parent point.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//draw includes
+#include "TrajectoryTopology.h"
+
+//edepsim includes
+#include "TG4Event.h"
+
+//c++ includes
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace
+{
+  using point_t = std::array<double, 3>;
+
+  point_t Position(const TG4TrajectoryPoint& point)
+  {
+    #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
+    const auto& pos = point.GetPosition();
+    #else
+    const auto& pos = point.Position;
+    #endif
+    return {{pos.X(), pos.Y(), pos.Z()}};
+  }
+
+  double Dist2(const point_t& first, const point_t& second)
+  {
+    const double dx = first[0]-second[0], dy = first[1]-second[1], dz = first[2]-second[2];
+    return dx*dx + dy*dy + dz*dz;
+  }
+
+  //Below this many distance calculations, searching every point is faster than building a PointTree
+  constexpr size_t maxBruteForce = 256;
+
+  //Index of the point closest to target.  Ties go to the earliest point.  
+  size_t BruteForceNearest(const std::vector<point_t>& points, const point_t& target)
+  {
+    size_t best = 0;
+    double bestDist2 = std::numeric_limits<double>::max();
+    for(size_t which = 0; which < points.size(); ++which)
+    {
+      const double dist2 = Dist2(points[which], target);
+      if(dist2 < bestDist2)
+      {
+        best = which;
+        bestDist2 = dist2;
+      }
+    }
+    return best;
+  }
+
+  //Implicit kd-tree over one trajectory's points.  Each range of fIndices is split at its median along one axis, and 
+  //the axis cycles with depth.  
+  class PointTree
+  {
+    public:
+      PointTree(const std::vector<point_t>& points): fPoints(points), fIndices(points.size())
+      {
+        for(size_t which = 0; which < fIndices.size(); ++which) fIndices[which] = which;
+        Build(0, fIndices.size(), 0);
+      }
+
+      //Same answer as BruteForceNearest()
+      size_t Nearest(const point_t& target) const
+      {
+        size_t best = 0;
+        double bestDist2 = std::numeric_limits<double>::max();
+        Search(0, fIndices.size(), 0, target, best, bestDist2);
+        return best;
+      }
+
+    private:
+      const std::vector<point_t>& fPoints;
+      std::vector<size_t> fIndices;
+
+      void Build(const size_t begin, const size_t end, const size_t axis)
+      {
+        if(end - begin < 2) return;
+        const size_t mid = (begin + end)/2;
+        std::nth_element(fIndices.begin()+begin, fIndices.begin()+mid, fIndices.begin()+end, 
+                         [this, axis](const size_t first, const size_t second) 
+                         { return fPoints[first][axis] < fPoints[second][axis]; });
+        Build(begin, mid, (axis+1)%3);
+        Build(mid+1, end, (axis+1)%3);
+      }
+
+      void Search(const size_t begin, const size_t end, const size_t axis, const point_t& target, size_t& best, 
+                  double& bestDist2) const
+      {
+        if(begin >= end) return;
+        const size_t mid = (begin + end)/2;
+        const size_t index = fIndices[mid];
+        const double dist2 = Dist2(fPoints[index], target);
+        if(dist2 < bestDist2 || (dist2 == bestDist2 && index < best))
+        {
+          best = index;
+          bestDist2 = dist2;
+        }
+
+        //Search the side of the split that target is on first.  The other side can only matter if the splitting plane 
+        //is no farther away than the best point so far.  
+        const double diff = target[axis] - fPoints[index][axis];
+        const size_t next = (axis+1)%3;
+        if(diff < 0)
+        {
+          Search(begin, mid, next, target, best, bestDist2);
+          if(diff*diff <= bestDist2) Search(mid+1, end, next, target, best, bestDist2);
+        }
+        else
+        {
+          Search(mid+1, end, next, target, best, bestDist2);
+          if(diff*diff <= bestDist2) Search(begin, mid, next, target, best, bestDist2);
+        }
+      }
+  };
+}
+
+namespace draw
+{
+  TrajectoryTopology::TrajectoryTopology(const EventView& view)
+  {
+    //Attach each child to the closest point on its parent.  Children of trajectories that aren't in this event, children 
+    //without points, and children of parents without points are never drawn.
+    std::vector<point_t> points;
+    for(const auto& traj: view.Event().Trajectories)
+    {
+      #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
+      const int id = traj.GetTrackId();
+      #else
+      const int id = traj.TrackId;
+      #endif
+      const auto trajPoints = EventView::Points(traj);
+      const auto trajChildren = view.Children(id);
+      if(trajChildren.empty() || trajPoints.empty()) continue;
+
+      points.clear();
+      for(const auto& point: trajPoints) points.push_back(::Position(point));
+
+      std::vector<Child> children;
+      children.reserve(trajChildren.size());
+      if(points.size()*trajChildren.size() <= maxBruteForce)
+      {
+        for(const auto child: trajChildren)
+        {
+          if(!child->Points.empty()) children.push_back({BruteForceNearest(points, ::Position(child->Points.front())), child});
+        }
+      }
+      else
+      {
+        const PointTree tree(points);
+        for(const auto child: trajChildren)
+        {
+          if(!child->Points.empty()) children.push_back({tree.Nearest(::Position(child->Points.front())), child});
+        }
+      }
+
+      std::stable_sort(children.begin(), children.end(), [](const Child& first, const Child& second) 
+                                                         { return first.fPoint < second.fPoint; });
+      fChildren[id] = std::move(children);
+    }
+  }
+
+  const std::vector<TrajectoryTopology::Child>& TrajectoryTopology::Children(const int trackID) const
+  {
+    static const std::vector<Child> noChildren;
+    const auto found = fChildren.find(trackID);
+    if(found == fChildren.end()) return noChildren;
+    return found->second;
+  }
+
+  const TrajectoryTopology& TrajectoryTopology::Get(const TG4Event& evt, Services& services)
+  {
+    if(!services.fTopology) services.fTopology = std::make_shared<TrajectoryTopology>(EventView::Get(evt, services));
+    return *services.fTopology;
+  }
+}
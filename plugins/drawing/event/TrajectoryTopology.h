@@ -0,0 +1,49 @@
+//File: TrajectoryTopology.h
+//Brief: Works out once per event which point on its parent each TG4Trajectory starts closest to so that trajectory 
+//       plugins can draw children under the right parent point.  Parents with only a few children are searched 
+//       directly, and the rest get a kd-tree over their points, so big EM showers no longer cost 
+//       O(children x points) per track.  Built on top of an EventView.  Every plugin drawing the same event shares one 
+//       TrajectoryTopology through Services.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//draw includes
+#include "EventView.h"
+
+//c++ includes
+#include <vector>
+#include <unordered_map>
+
+#ifndef DRAW_TRAJECTORYTOPOLOGY_H
+#define DRAW_TRAJECTORYTOPOLOGY_H
+
+class TG4Event;
+class TG4Trajectory;
+
+namespace draw
+{
+  class TrajectoryTopology
+  {
+    public:
+      TrajectoryTopology(const EventView& view);
+
+      //A child trajectory and the index of the point on its parent that it starts closest to
+      struct Child
+      {
+        size_t fPoint; 
+        const TG4Trajectory* fTraj;
+      };
+
+      //Children of trackID sorted by the point they attach to.  Children that attach to the same point stay in the order 
+      //they appear in the event.  
+      const std::vector<Child>& Children(const int trackID) const;
+
+      //The TrajectoryTopology for evt.  It is only built by the first plugin to ask for it after the application 
+      //resets services.fTopology for a new event.
+      static const TrajectoryTopology& Get(const TG4Event& evt, Services& services);
+
+    private:
+      std::unordered_map<int, std::vector<Child>> fChildren; //Track ID of parent to its children
+  };
+}
+
+#endif //DRAW_TRAJECTORYTOPOLOGY_H
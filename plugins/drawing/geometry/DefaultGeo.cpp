@@ -5,13 +5,14 @@
 
 //draw includes
 #include "DefaultGeo.h"
+#include "GeoCache.h"
 
 //util includes
 #include "util/ColorIter.cxx"
 
 //gl includes
 #include "gl/metadata/Column.cpp"
-#include "gl/model/PolyMesh.h"
+#include "gl/model/MeshInstance.h"
 
 //ROOT includes
 #include "TGeoNode.h"
@@ -20,8 +21,14 @@
 //glm includes
 #include <glm/gtc/type_ptr.hpp>
 
+//POSIX includes for mkdir()
+#include <sys/stat.h>
+
 //c++ includes
 #include <iostream>
+#include <sstream>
+#include <cstdlib> //std::getenv()
+#include <cerrno>
 
 namespace
 {
@@ -34,24 +41,48 @@ namespace
     }
     return result;
   }
+
+  //Default directory for geometry cache files following the XDG base directory convention
+  std::string defaultCacheDir()
+  {
+    if(const char* xdg = std::getenv("XDG_CACHE_HOME")) return std::string(xdg) + "/edepViewer";
+    if(const char* home = std::getenv("HOME")) return std::string(home) + "/.cache/edepViewer";
+    return "";
+  }
+
+  //Like mkdir -p.  Returns false if dir does not exist and could not be created.
+  bool makeDirs(const std::string& dir)
+  {
+    for(auto slash = dir.find('/', 1); ; slash = dir.find('/', slash+1))
+    {
+      const auto parent = dir.substr(0, slash);
+      if(mkdir(parent.c_str(), 0755) != 0 && errno != EEXIST) return false;
+      if(slash == std::string::npos) return true;
+    }
+  }
 }
 
 namespace draw
 {
-  DefaultGeo::DefaultGeo(const YAML::Node& config): fMaxDepth(3), fDefaultDraw(false), fColor(new mygl::ColorIter()), fGeoRecord(new GeoRecord())
+  DefaultGeo::DefaultGeo(const YAML::Node& config): fMaxDepth(3), fDefaultDraw(false), fCacheDir(defaultCacheDir()), fCull(true), 
+                                                    fCollapsePixels(4), fColor(new mygl::ColorIter()), fGeoRecord(new GeoRecord())
   {
     if(config["MaxDepth"]) fMaxDepth = config["MaxDepth"].as<unsigned int>();
     if(config["DefaultDraw"]) fDefaultDraw = config["DefaultDraw"].as<bool>();
+    if(config["CacheDir"]) fCacheDir = config["CacheDir"].as<std::string>();
+    if(config["Cache"] && !config["Cache"].as<bool>()) fCacheDir = "";
+    if(config["Cull"]) fCull = config["Cull"].as<bool>();
+    if(config["CollapsePixels"]) fCollapsePixels = config["CollapsePixels"].as<float>();
   }
 
-  void DefaultGeo::AppendChildren(legacy::model_t::view& parent, TGeoNode* parentNode, glm::mat4& mat, size_t depth)
+  void DefaultGeo::AppendChildren(GeoCache& cache, const int64_t parent, TGeoNode* parentNode, glm::mat4& mat, size_t depth)
   {
     auto children = parentNode->GetNodes();
     if(depth == fMaxDepth) return;
-    for(auto child: *children) AppendNode(parent, (TGeoNode*)(child), mat, depth+1);
+    for(auto child: *children) AppendNode(cache, parent, (TGeoNode*)(child), mat, depth+1);
   }
 
-  void DefaultGeo::AppendNode(legacy::model_t::view& parent, TGeoNode* node, glm::mat4& mat, size_t depth)
+  void DefaultGeo::AppendNode(GeoCache& cache, const int64_t parent, TGeoNode* node, glm::mat4& mat, size_t depth)
   {
     //TODO: This is actually a pretty cool way to make a basic ASCII hierarchical representation.  Maybe enable it in DEBUG mode?
     //for(size_t tab = 0; tab < depth; ++tab) std::cout << "  ";
@@ -66,32 +97,69 @@ namespace draw
     auto local = glm::make_mat4(floatPtr);
     local = mat*::transposeRot(local);
 
-    auto row = parent.emplace<mygl::PolyMesh>(true, local, node->GetVolume(), glm::vec4((glm::vec3)(*fColor), 0.2));
-
-    row[fGeoRecord->fName] = node->GetName();
-    row[fGeoRecord->fMaterial] = node->GetVolume()->GetMaterial()->GetName();
+    //Nodes that are placements of the same TGeoVolume share one tesselation in cache.fMeshes
+    cache.fNodes.push_back(GeoCache::Node{parent, cache.fMeshes.Find(node->GetVolume()->GetShape()), local, 
+                                          glm::vec4((glm::vec3)(*fColor), 0.2), node->GetName(), 
+                                          node->GetVolume()->GetMaterial()->GetName()});
     ++(*fColor);
-    AppendChildren(row, node, local, depth);
+    AppendChildren(cache, cache.fNodes.size()-1, node, local, depth);
   }
 
   std::unique_ptr<legacy::model_t> DefaultGeo::doDraw(const TGeoManager& data, Services& /*services*/)
   {
-    //TODO: Reset fColor here.  It probably needs to be a local variable instead of a member variable. 
-    glm::mat4 id;
+    //Try to skip tesselation by reading a cache file for this geometry
+    std::unique_ptr<GeoCache> cache;
+    uint64_t hash = 0;
+    std::string cacheFile;
+    if(!fCacheDir.empty())
+    {
+      hash = GeoCache::Hash(data, fMaxDepth);
+      std::stringstream name;
+      name << fCacheDir << "/geo_" << std::hex << hash << ".bin";
+      cacheFile = name.str();
+      cache = GeoCache::Read(cacheFile, hash);
+    }
+
+    if(!cache)
+    {
+      //TODO: Reset fColor here.  It probably needs to be a local variable instead of a member variable. 
+      glm::mat4 id;
+      cache.reset(new GeoCache());
+      cache->fTitle = data.GetTitle();
+      AppendNode(*cache, -1, data.GetTopNode(), id, 0); 
+
+      if(!cacheFile.empty())
+      {
+        if(makeDirs(fCacheDir)) cache->Write(cacheFile, hash);
+        else std::cerr << "Failed to create directory " << fCacheDir << " for geometry cache files.  Geometry will not be cached.\n";
+      }
+    }
+
     auto scene = std::make_unique<legacy::model_t>(fGeoRecord);
     auto top = scene->emplace(fDefaultDraw);
-    top[fGeoRecord->fName] = data.GetTitle();
+    top[fGeoRecord->fName] = cache->fTitle;
     top[fGeoRecord->fMaterial] = "FIXME";
-    AppendNode(top, data.GetTopNode(), id, 0); 
+
+    //Parents always come before their children in cache->fNodes
+    std::vector<legacy::model_t::view> views;
+    views.reserve(cache->fNodes.size());
+    for(const auto& node: cache->fNodes)
+    {
+      auto& parent = (node.fParent < 0)?top:views[node.fParent];
+      auto row = parent.emplace<mygl::MeshInstance>(true, node.fModel, &(cache->fMeshes), size_t(node.fMesh), node.fColor);
+      row[fGeoRecord->fName] = node.fName;
+      row[fGeoRecord->fMaterial] = node.fMaterial;
+      views.push_back(row);
+    }
+
     return scene;
   }
 
   legacy::scene_t& DefaultGeo::doRequestScene(mygl::Viewer& viewer)
   {
-    return viewer.MakeScene("Geometry", fGeoRecord, INSTALL_GLSL_DIR "/colorPerVertex.frag", INSTALL_GLSL_DIR "/colorPerVertex.vert", 
-                            INSTALL_GLSL_DIR "/triangleBorder.geom", std::unique_ptr<mygl::SceneConfig>(new GeoConfig()));
+    return viewer.MakeScene("Geometry", fGeoRecord, INSTALL_GLSL_DIR "/colorPerVertex.frag", INSTALL_GLSL_DIR "/meshInstance.vert", 
+                            INSTALL_GLSL_DIR "/triangleBorder.geom", std::unique_ptr<mygl::SceneConfig>(new GeoConfig(fCull, fCollapsePixels)));
   }
 
   REGISTER_GEO(DefaultGeo);
 }
-
@@ -12,6 +12,9 @@
 //yaml-cpp include for configuration
 #include "yaml-cpp/yaml.h"
 
+//c++ includes
+#include <cstdint>
+
 #ifndef DRAW_DEFAULTGEO_H
 #define DRAW_DEFAULTGEO_H
 
@@ -23,6 +26,8 @@ namespace mygl
 
 namespace draw
 {
+  class GeoCache;
+
   class DefaultGeo
   {
     public:
@@ -33,13 +38,16 @@ namespace draw
       virtual std::unique_ptr<legacy::model_t> doDraw(const TGeoManager& data, Services& /*services*/);
 
     private:
-      //Helper functions for drawing geometry volumes
-      virtual void AppendNode(legacy::model_t::view& parent, TGeoNode* node, glm::mat4& mat, size_t depth);
-      virtual void AppendChildren(legacy::model_t::view& parent, TGeoNode* parentNode, glm::mat4& mat, size_t depth);
+      //Helper functions for adding geometry volumes to a GeoCache.  parent is the index of node's parent in cache.fNodes.
+      virtual void AppendNode(GeoCache& cache, const int64_t parent, TGeoNode* node, glm::mat4& mat, size_t depth);
+      virtual void AppendChildren(GeoCache& cache, const int64_t parent, TGeoNode* parentNode, glm::mat4& mat, size_t depth);
 
       //Data needed when appending geometry nodes
       size_t fMaxDepth; //The maximum depth drawn in geometry hierarchy
       bool fDefaultDraw; //Whether to draw all geometry nodes by default
+      std::string fCacheDir; //Directory where tesselated geometries are cached.  Caching is disabled if empty.
+      bool fCull; //Whether to skip drawing volumes outside the Camera's view
+      float fCollapsePixels; //Volumes smaller than this many pixels on screen are drawn without their daughters
       std::unique_ptr<mygl::ColorIter> fColor; //TODO: Use some Service here instead?
 
       //ColRecord-derived classes to make unique TreeViews for geometry and trajectories
@@ -61,7 +69,7 @@ namespace draw
       class GeoConfig: public mygl::SceneConfig
       {
         public:
-          GeoConfig() = default;
+          GeoConfig(const bool cull, const float collapsePixels): fCull(cull), fCollapsePixels(collapsePixels) {}
           virtual ~GeoConfig() = default;
 
           virtual void BeforeRender() override
@@ -71,6 +79,13 @@ namespace draw
           virtual void AfterRender() override
           {
           }
+
+          virtual bool CullOutsideView() const override { return fCull; }
+          virtual float CollapsePixels() const override { return fCollapsePixels; }
+
+        private:
+          bool fCull; //Skip volumes outside the Camera's view
+          float fCollapsePixels; //Don't draw daughters of volumes smaller than this many pixels on screen
       };
   };
 }
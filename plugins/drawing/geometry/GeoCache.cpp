@@ -0,0 +1,369 @@
+//File: GeoCache.cpp
+//Brief: Reads and writes everything DefaultGeo draws for one geometry in a binary format that can be mmap()ed.  
+//       The file is laid out as a Header followed by fixed-size arrays of MeshRecords, vertices, indices, polygon 
+//       sizes, NodeRecords, and finally every string concatenated.  Each array starts on an 8 byte boundary, so 
+//       vertices and indices can be handed straight from the mapped file to VAO::model::Register().  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//draw includes
+#include "plugins/drawing/geometry/GeoCache.h"
+
+//ROOT includes
+#include "TGeoManager.h"
+#include "TGeoNode.h"
+#include "TGeoVolume.h"
+#include "TGeoMatrix.h"
+#include "TGeoMaterial.h"
+#include "TBufferFile.h"
+
+//POSIX includes for memory-mapping cache files
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+//c++ includes
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <cstdio> //std::rename()
+#include <unordered_map>
+
+namespace
+{
+  constexpr char magic[8] = {'E', 'V', 'D', 'G', 'E', 'O', '\0', '\0'};
+  constexpr uint32_t version = 2; //Increment whenever the layout of a cache file or tesselation changes
+
+  struct Header
+  {
+    char fMagic[8];
+    uint32_t fVersion;
+    uint32_t fVertexSize; //sizeof(Drawable::Vertex) when this file was written
+    uint64_t fHash;
+    uint64_t fNMeshes;
+    uint64_t fNVertices;
+    uint64_t fNIndices;
+    uint64_t fNPolygons;
+    uint64_t fNNodes;
+    uint64_t fNChars;
+    uint64_t fTitle; //Position of the title in the string table
+    uint64_t fTitleLength;
+  };
+
+  struct MeshRecord
+  {
+    uint64_t fFirstVertex;
+    uint64_t fNVertices;
+    uint64_t fFirstIndex;
+    uint64_t fNIndices;
+    uint64_t fFirstPolygon;
+    uint64_t fNPolygons;
+  };
+
+  struct NodeRecord
+  {
+    int64_t fParent;
+    uint64_t fMesh;
+    float fModel[16];
+    float fColor[4];
+    uint64_t fName; //Position in the string table
+    uint64_t fNameLength;
+    uint64_t fMaterial;
+    uint64_t fMaterialLength;
+  };
+
+  //Round nBytes up to the alignment of every array in a cache file
+  size_t padded(const size_t nBytes)
+  {
+    return (nBytes + 7)/8*8;
+  }
+
+  //64 bit FNV-1a hash.  Not cryptographic, but plenty to tell geometries apart.
+  class Hasher
+  {
+    public:
+      Hasher(): fValue(14695981039346656037ull) {}
+
+      void Add(const void* data, const size_t nBytes)
+      {
+        const auto bytes = static_cast<const unsigned char*>(data);
+        for(size_t pos = 0; pos < nBytes; ++pos)
+        {
+          fValue ^= bytes[pos];
+          fValue *= 1099511628211ull;
+        }
+      }
+
+      template <class T>
+      void Add(const T& value)
+      {
+        Add(&value, sizeof(T));
+      }
+
+      void Add(const std::string& value)
+      {
+        Add(value.size());
+        Add(value.data(), value.size());
+      }
+
+      uint64_t fValue;
+  };
+
+  //Hash everything about node that DefaultGeo draws.  Shapes are hashed from ROOT's streamed representation, 
+  //which includes all of their dimensions but not pointers, the first time they are seen.  
+  void hashNode(Hasher& hash, TGeoNode* node, const size_t depth, const size_t maxDepth, std::unordered_map<const TGeoShape*, uint64_t>& shapes)
+  {
+    hash.Add(std::string(node->GetName()));
+    auto vol = node->GetVolume();
+    hash.Add(std::string(vol->GetName()));
+    hash.Add(std::string(vol->GetMaterial()->GetName()));
+
+    double matrix[16] = {};
+    node->GetMatrix()->GetHomogenousMatrix(matrix);
+    hash.Add(matrix, sizeof(matrix));
+
+    auto shape = vol->GetShape();
+    const auto found = shapes.find(shape);
+    if(found != shapes.end()) hash.Add(found->second);
+    else
+    {
+      const uint64_t id = shapes.size();
+      shapes[shape] = id;
+      hash.Add(id);
+      hash.Add(std::string(shape->ClassName()));
+      TBufferFile buffer(TBuffer::kWrite);
+      shape->Streamer(buffer);
+      hash.Add(buffer.Buffer(), buffer.Length());
+    }
+
+    if(depth == maxDepth) return;
+    auto children = node->GetNodes();
+    const uint64_t nChildren = (children == nullptr)?0:children->GetEntriesFast();
+    hash.Add(nChildren);
+    if(children == nullptr) return;
+    for(auto child: *children) hashNode(hash, (TGeoNode*)(child), depth+1, maxDepth, shapes);
+  }
+
+  //Keeps a memory-mapped file open for as long as anything points into it
+  struct Mapping
+  {
+    Mapping(void* data, const size_t size): fData(data), fSize(size) {}
+    ~Mapping() { munmap(fData, fSize); }
+
+    void* fData;
+    size_t fSize;
+  };
+}
+
+namespace draw
+{
+  uint64_t GeoCache::Hash(const TGeoManager& man, const size_t maxDepth)
+  {
+    Hasher hash;
+    hash.Add(version);
+    hash.Add(uint64_t(maxDepth));
+    hash.Add(man.GetNsegments()); //Changes how curved shapes are tesselated
+    hash.Add(std::string(man.GetTitle()));
+    std::unordered_map<const TGeoShape*, uint64_t> shapes;
+    hashNode(hash, man.GetTopNode(), 0, maxDepth, shapes);
+    return hash.fValue;
+  }
+
+  void GeoCache::Write(const std::string& fileName, const uint64_t hash) const
+  {
+    Header header;
+    std::memcpy(header.fMagic, magic, sizeof(magic));
+    header.fVersion = version;
+    header.fVertexSize = sizeof(mygl::Drawable::Vertex);
+    header.fHash = hash;
+    header.fNMeshes = fMeshes.size();
+    header.fNVertices = 0;
+    header.fNIndices = 0;
+    header.fNPolygons = 0;
+    header.fNNodes = fNodes.size();
+
+    std::vector<MeshRecord> meshes;
+    meshes.reserve(fMeshes.size());
+    for(size_t mesh = 0; mesh < fMeshes.size(); ++mesh)
+    {
+      const auto& tess = fMeshes[mesh];
+      meshes.push_back(MeshRecord{header.fNVertices, tess.fNVertices, header.fNIndices, tess.fNIndices, header.fNPolygons, tess.fNPolygons});
+      header.fNVertices += tess.fNVertices;
+      header.fNIndices += tess.fNIndices;
+      header.fNPolygons += tess.fNPolygons;
+    }
+
+    std::string strings = fTitle;
+    header.fTitle = 0;
+    header.fTitleLength = fTitle.size();
+    std::vector<NodeRecord> nodes;
+    nodes.reserve(fNodes.size());
+    for(const auto& node: fNodes)
+    {
+      NodeRecord record;
+      record.fParent = node.fParent;
+      record.fMesh = node.fMesh;
+      for(size_t col = 0; col < 4; ++col)
+      {
+        for(size_t row = 0; row < 4; ++row) record.fModel[4*col+row] = node.fModel[col][row];
+      }
+      for(size_t comp = 0; comp < 4; ++comp) record.fColor[comp] = node.fColor[comp];
+      record.fName = strings.size();
+      record.fNameLength = node.fName.size();
+      strings += node.fName;
+      record.fMaterial = strings.size();
+      record.fMaterialLength = node.fMaterial.size();
+      strings += node.fMaterial;
+      nodes.push_back(record);
+    }
+    header.fNChars = strings.size();
+
+    //Write to a temporary file first so that a crash never leaves a partial cache behind
+    const auto tmpName = fileName + ".tmp";
+    std::ofstream file(tmpName, std::ios::binary | std::ios::trunc);
+    if(!file)
+    {
+      std::cerr << "Failed to open geometry cache file " << tmpName << " for writing.  Geometry will not be cached.\n";
+      return;
+    }
+
+    const char zeros[8] = {};
+    const auto writeArray = [&file, &zeros](const void* data, const size_t nBytes)
+    {
+      file.write(static_cast<const char*>(data), nBytes);
+      file.write(zeros, padded(nBytes) - nBytes);
+    };
+
+    writeArray(&header, sizeof(header));
+    writeArray(meshes.data(), meshes.size()*sizeof(MeshRecord));
+    for(size_t mesh = 0; mesh < fMeshes.size(); ++mesh) file.write((const char*)fMeshes[mesh].fVertices, fMeshes[mesh].fNVertices*sizeof(mygl::Drawable::Vertex));
+    file.write(zeros, padded(header.fNVertices*sizeof(mygl::Drawable::Vertex)) - header.fNVertices*sizeof(mygl::Drawable::Vertex));
+    for(size_t mesh = 0; mesh < fMeshes.size(); ++mesh) file.write((const char*)fMeshes[mesh].fIndices, fMeshes[mesh].fNIndices*sizeof(unsigned int));
+    file.write(zeros, padded(header.fNIndices*sizeof(unsigned int)) - header.fNIndices*sizeof(unsigned int));
+    for(size_t mesh = 0; mesh < fMeshes.size(); ++mesh) file.write((const char*)fMeshes[mesh].fPolygonSizes, fMeshes[mesh].fNPolygons*sizeof(int));
+    file.write(zeros, padded(header.fNPolygons*sizeof(int)) - header.fNPolygons*sizeof(int));
+    writeArray(nodes.data(), nodes.size()*sizeof(NodeRecord));
+    writeArray(strings.data(), strings.size());
+    file.close();
+
+    if(!file || std::rename(tmpName.c_str(), fileName.c_str()) != 0)
+    {
+      std::cerr << "Failed to write geometry cache file " << fileName << ".  Geometry will not be cached.\n";
+      std::remove(tmpName.c_str());
+    }
+  }
+
+  std::unique_ptr<GeoCache> GeoCache::Read(const std::string& fileName, const uint64_t hash)
+  {
+    const int fd = open(fileName.c_str(), O_RDONLY);
+    if(fd < 0) return nullptr; //No cache for this geometry yet
+
+    struct stat status;
+    if(fstat(fd, &status) != 0 || size_t(status.st_size) < sizeof(Header))
+    {
+      close(fd);
+      return nullptr;
+    }
+
+    const size_t size = status.st_size;
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); //The mapping stays valid after the file descriptor is closed
+    if(data == MAP_FAILED) return nullptr;
+    auto mapping = std::make_shared<Mapping>(data, size);
+
+    const auto begin = static_cast<const char*>(data);
+    const auto& header = *reinterpret_cast<const Header*>(begin);
+    if(std::memcmp(header.fMagic, magic, sizeof(magic)) != 0 || header.fVersion != version 
+       || header.fVertexSize != sizeof(mygl::Drawable::Vertex) || header.fHash != hash) return nullptr;
+
+    //Find each array and make sure the file is as long as the header says it is
+    size_t pos = padded(sizeof(Header));
+    const auto next = [&pos](const size_t nBytes)
+    {
+      const auto start = pos;
+      pos += padded(nBytes);
+      return start;
+    };
+    const auto meshPos = next(header.fNMeshes*sizeof(MeshRecord));
+    const auto vertexPos = next(header.fNVertices*sizeof(mygl::Drawable::Vertex));
+    const auto indexPos = next(header.fNIndices*sizeof(unsigned int));
+    const auto polygonPos = next(header.fNPolygons*sizeof(int));
+    const auto nodePos = next(header.fNNodes*sizeof(NodeRecord));
+    const auto stringPos = next(header.fNChars);
+    if(pos > size)
+    {
+      std::cerr << "Geometry cache file " << fileName << " is truncated.  Ignoring it.\n";
+      return nullptr;
+    }
+
+    const auto meshes = reinterpret_cast<const MeshRecord*>(begin + meshPos);
+    const auto vertices = reinterpret_cast<const mygl::Drawable::Vertex*>(begin + vertexPos);
+    const auto indices = reinterpret_cast<const unsigned int*>(begin + indexPos);
+    const auto polygons = reinterpret_cast<const int*>(begin + polygonPos);
+    const auto nodes = reinterpret_cast<const NodeRecord*>(begin + nodePos);
+    const auto strings = begin + stringPos;
+
+    //Every string has to be inside the string table.  Written this way so that huge lengths can't overflow.
+    const auto validString = [&header](const uint64_t start, const uint64_t length)
+    {
+      return length <= header.fNChars && start <= header.fNChars - length;
+    };
+
+    std::unique_ptr<GeoCache> cache(new GeoCache());
+    if(!validString(header.fTitle, header.fTitleLength))
+    {
+      std::cerr << "Geometry cache file " << fileName << " is corrupted.  Ignoring it.\n";
+      return nullptr;
+    }
+    cache->fTitle.assign(strings + header.fTitle, header.fTitleLength);
+
+    //Meshes point straight into the mapped file
+    for(size_t mesh = 0; mesh < header.fNMeshes; ++mesh)
+    {
+      const auto& record = meshes[mesh];
+      if(record.fFirstVertex + record.fNVertices > header.fNVertices || record.fFirstIndex + record.fNIndices > header.fNIndices
+         || record.fFirstPolygon + record.fNPolygons > header.fNPolygons)
+      {
+        std::cerr << "Geometry cache file " << fileName << " is corrupted.  Ignoring it.\n";
+        return nullptr;
+      }
+
+      mygl::MeshCache::Tessellation tess;
+      tess.fVertices = vertices + record.fFirstVertex;
+      tess.fNVertices = record.fNVertices;
+      tess.fIndices = indices + record.fFirstIndex;
+      tess.fNIndices = record.fNIndices;
+      tess.fPolygonSizes = polygons + record.fFirstPolygon;
+      tess.fNPolygons = record.fNPolygons;
+      cache->fMeshes.Add(tess, mapping);
+    }
+
+    cache->fNodes.reserve(header.fNNodes);
+    for(size_t node = 0; node < header.fNNodes; ++node)
+    {
+      const auto& record = nodes[node];
+
+      //DefaultGeo looks up each Node's parent while drawing it, so parents must come first
+      if(record.fMesh >= header.fNMeshes || record.fParent < -1 || record.fParent >= int64_t(node)
+         || !validString(record.fName, record.fNameLength) || !validString(record.fMaterial, record.fMaterialLength))
+      {
+        std::cerr << "Geometry cache file " << fileName << " is corrupted.  Ignoring it.\n";
+        return nullptr;
+      }
+
+      Node result;
+      result.fParent = record.fParent;
+      result.fMesh = record.fMesh;
+      for(size_t col = 0; col < 4; ++col)
+      {
+        for(size_t row = 0; row < 4; ++row) result.fModel[col][row] = record.fModel[4*col+row];
+      }
+      result.fColor = glm::vec4(record.fColor[0], record.fColor[1], record.fColor[2], record.fColor[3]);
+      result.fName.assign(strings + record.fName, record.fNameLength);
+      result.fMaterial.assign(strings + record.fMaterial, record.fMaterialLength);
+      cache->fNodes.push_back(std::move(result));
+    }
+
+    return cache;
+  }
+}
@@ -0,0 +1,63 @@
+//File: GeoCache.h
+//Brief: A GeoCache holds everything DefaultGeo draws for one geometry: the unique tesselated meshes, the node hierarchy, 
+//       and the names and materials of nodes.  It can be written to a compact binary file and read back with mmap() 
+//       on the next run so that a known geometry skips ROOT's tesselation entirely.  Cache files are keyed by 
+//       Hash(), which summarizes the shapes, placements, and materials of the nodes DefaultGeo would draw.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef DRAW_GEOCACHE_H
+#define DRAW_GEOCACHE_H
+
+//gl includes
+#include "gl/model/MeshCache.h"
+
+//glm includes
+#include <glm/glm.hpp>
+
+//c++ includes
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+class TGeoManager;
+
+namespace draw
+{
+  class GeoCache
+  {
+    public:
+      //One TGeoNode in the order DefaultGeo visits them.  fParent is the index of this Node's parent in fNodes 
+      //or -1 for the top node.
+      struct Node
+      {
+        int64_t fParent;
+        uint64_t fMesh; //Index in fMeshes
+        glm::mat4 fModel;
+        glm::vec4 fColor;
+        std::string fName;
+        std::string fMaterial;
+      };
+
+      GeoCache() = default;
+      virtual ~GeoCache() = default;
+
+      mygl::MeshCache fMeshes; //Unique shapes used by fNodes
+      std::vector<Node> fNodes; //Parents always come before their children
+      std::string fTitle; //Title of the TGeoManager
+
+      //Summary of the parts of man that DefaultGeo draws down to maxDepth.  Geometries with the same Hash() 
+      //can share a cache file.
+      static uint64_t Hash(const TGeoManager& man, const size_t maxDepth);
+
+      //Write this GeoCache to fileName.  Prints a warning instead of throwing if fileName can't be written 
+      //because the cache is only an optimization.
+      void Write(const std::string& fileName, const uint64_t hash) const;
+
+      //Read a GeoCache written by Write().  Returns nullptr if fileName doesn't exist, was made for a 
+      //different hash, was written by an incompatible version of this code, or is corrupted.
+      static std::unique_ptr<GeoCache> Read(const std::string& fileName, const uint64_t hash);
+  };
+}
+
+#endif //DRAW_GEOCACHE_H
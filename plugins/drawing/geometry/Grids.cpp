@@ -19,9 +19,11 @@
 
 namespace draw
 {
-  Grids::Grids(const YAML::Node& config): fGuideRecord(new GuideRecord()), fLineWidth(0.006), fDefaultDraw(false)
+  Grids::Grids(const YAML::Node& config): fGuideRecord(new GuideRecord()), fLineWidth(0.006), fFadeSpacing(0.02), 
+                                          fDefaultDraw(false)
   {
     if(config["LineWidth"]) fLineWidth = config["LineWidth"].as<float>();
+    if(config["FadeSpacing"]) fFadeSpacing = config["FadeSpacing"].as<float>();
 
     if(config["DefaultDraw"]) fDefaultDraw = config["DefaultDraw"].as<bool>();
   }
@@ -29,7 +31,7 @@ namespace draw
   legacy::scene_t& Grids::doRequestScene(mygl::Viewer& viewer)
   {
     constexpr auto name = "Grids";
-    return viewer.MakeScene(name, fGuideRecord, INSTALL_GLSL_DIR "/colorPerVertex.frag", INSTALL_GLSL_DIR "/HUD.vert", 
+    return viewer.MakeScene(name, fGuideRecord, INSTALL_GLSL_DIR "/colorPerVertex.frag", INSTALL_GLSL_DIR "/grid.vert", 
                             INSTALL_GLSL_DIR "/wideLine.geom");
   }
 
@@ -42,22 +44,22 @@ namespace draw
     const double gridSize = 1e5;
     //A 1m grid 
     auto oneMrow = root.emplace<mygl::Grid>(false, glm::mat4(), gridSize, 1000., gridSize, 1000.,
-                                             glm::vec4(0.3f, 0.0f, 0.9f, 0.2f), fLineWidth);
+                                             glm::vec4(0.3f, 0.0f, 0.9f, 0.2f), fLineWidth, fFadeSpacing);
     oneMrow[fGuideRecord->fName] = "1m Grid";
 
     //A 1dm grid 
     auto oneDMrow = root.emplace<mygl::Grid>(false, glm::mat4(), gridSize, 100., gridSize, 100.,
-                                                  glm::vec4(0.3f, 0.0f, 0.9f, 0.2f), fLineWidth);
+                                                  glm::vec4(0.3f, 0.0f, 0.9f, 0.2f), fLineWidth, fFadeSpacing);
     oneDMrow[fGuideRecord->fName] = "1dm Grid";
 
     //A 1cm grid
     auto oneCMrow = root.emplace<mygl::Grid>(false, glm::mat4(), gridSize, 10., gridSize, 10.,
-                                                  glm::vec4(0.3f, 0.0f, 0.9f, 0.2f), fLineWidth);
+                                                  glm::vec4(0.3f, 0.0f, 0.9f, 0.2f), fLineWidth, fFadeSpacing);
     oneCMrow[fGuideRecord->fName] = "1cm Grid";
 
     //A 1mm grid
     auto oneMMrow = root.emplace<mygl::Grid>(false, glm::mat4(), gridSize, 1., gridSize, 1.,
-                                                  glm::vec4(0.3f, 0.0f, 0.9f, 0.2f), fLineWidth);
+                                                  glm::vec4(0.3f, 0.0f, 0.9f, 0.2f), fLineWidth, fFadeSpacing);
     oneMMrow[fGuideRecord->fName] = "1mm Grid";
 
     return scene;
@@ -42,6 +42,7 @@ namespace draw
 
       //Drawing configuration
       float fLineWidth; //Width of grid lines
+      float fFadeSpacing; //Grid lines closer together than this on screen fade out
       bool fDefaultDraw; //Draw all objects by default
   };
 }
@@ -0,0 +1,75 @@
+//File: GenieReaction.cpp
+//Brief: Parses the interaction string that GENIE writes into edep-sim's TG4PrimaryVertex::Reaction.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//util includes
+#include "util/GenieReaction.h"
+
+//c++ includes
+#include <cstring>
+#include <cctype>
+
+namespace
+{
+  //Cursor over the string being parsed.  Every function leaves pos where it stopped reading and returns false if 
+  //what it expected wasn't there.
+  bool Literal(const char*& pos, const char* end, const char* text)
+  {
+    const size_t length = std::strlen(text);
+    if(size_t(end - pos) < length || std::strncmp(pos, text, length) != 0) return false;
+    pos += length;
+    return true;
+  }
+
+  bool Integer(const char*& pos, const char* end, int& value, const bool allowSign)
+  {
+    bool negative = false;
+    if(allowSign && pos < end && *pos == '-')
+    {
+      negative = true;
+      ++pos;
+    }
+
+    if(pos == end || !std::isdigit(static_cast<unsigned char>(*pos))) return false;
+    long long sum = 0;
+    for(; pos < end && std::isdigit(static_cast<unsigned char>(*pos)); ++pos) sum = sum*10 + (*pos - '0');
+    value = static_cast<int>(negative ? -sum : sum);
+    return true;
+  }
+
+  bool Letters(const char*& pos, const char* end, util::GenieReaction::Substring& word)
+  {
+    word.fBegin = pos;
+    while(pos < end && std::isalpha(static_cast<unsigned char>(*pos))) ++pos;
+    word.fSize = pos - word.fBegin;
+    return word.fSize > 0;
+  }
+
+  //Matches proc:Weak[<letters>],<letters>; at pos
+  bool Process(const char* pos, const char* end, util::GenieReaction& result)
+  {
+    return Literal(pos, end, "proc:Weak[") && Letters(pos, end, result.fCurrent) && Literal(pos, end, "],") 
+           && Letters(pos, end, result.fProcess) && Literal(pos, end, ";");
+  }
+}
+
+namespace util
+{
+  bool ParseGenieReaction(const std::string& reaction, GenieReaction& result)
+  {
+    const char* pos = reaction.data();
+    const char* end = pos + reaction.size();
+
+    if(!(Literal(pos, end, "nu:") && Integer(pos, end, result.fNuPDG, true) 
+         && Literal(pos, end, ";tgt:") && Integer(pos, end, result.fTargetPDG, false)
+         && Literal(pos, end, ";N:") && Integer(pos, end, result.fNucleonPDG, false))) return false;
+
+    //Anything can come between the struck nucleon and the process.  Like the old regular expression, use the last 
+    //";proc:" that is followed by a well-formed process.  
+    for(const char* semicolon = end; semicolon-- > pos;)
+    {
+      if(*semicolon == ';' && Process(semicolon+1, end, result)) return true;
+    }
+    return false;
+  }
+}
@@ -0,0 +1,40 @@
+//File: GenieReaction.h
+//Brief: Parses the interaction string that GENIE writes into edep-sim's TG4PrimaryVertex::Reaction, like 
+//       "nu:14;tgt:1000180400;N:2112;proc:Weak[CC],QES;".  Replaces a std::regex that trajectory plugins built for 
+//       every event.  Parsing never allocates, and the result points into the string it was parsed from, so that 
+//       string has to outlive it.  Safe to call from any number of threads at once.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//c++ includes
+#include <string>
+#include <cstddef>
+
+#ifndef UTIL_GENIEREACTION_H
+#define UTIL_GENIEREACTION_H
+
+namespace util
+{
+  struct GenieReaction
+  {
+    //Part of the string that was parsed
+    struct Substring
+    {
+      const char* fBegin = nullptr;
+      size_t fSize = 0;
+
+      std::string str() const { return std::string(fBegin, fSize); }
+    };
+
+    int fNuPDG = 0; //PDG code of the incoming neutrino
+    int fTargetPDG = 0; //PDG code of the target nucleus
+    int fNucleonPDG = 0; //PDG code of the struck nucleon
+    Substring fCurrent; //What was inside Weak[], like CC or NC
+    Substring fProcess; //What comes after Weak[], like QES or DIS
+  };
+
+  //Returns false and leaves result in an unspecified state if reaction doesn't look like 
+  //nu:<int>;tgt:<digits>;N:<digits><anything>;proc:Weak[<letters>],<letters>;<anything>
+  bool ParseGenieReaction(const std::string& reaction, GenieReaction& result);
+}
+
+#endif //UTIL_GENIEREACTION_H
@@ -2,6 +2,19 @@
 //Brief: Provides access to specific geometry functions for drawing plugins.  Can cache results of expensive volume lookups 
 //       since it controls the lifetime of the TGeoManager it uses.  When loading a new file, this object needs to be 
 //       destroyed.  
+//
+//       FindMaterial() is accelerated by a grid of voxels over the fiducial volume's bounding box.  Each voxel is 
+//       classified the first time a point lands in it by asking the navigator for the material at its center and 
+//       8 corners.  If they all agree, later lookups in that voxel are a single array read.  Voxels that straddle a 
+//       material boundary, and points outside the grid, still go to TGeoManager::FindNode().  A volume thinner than 
+//       a voxel that misses all 9 sample points is invisible to the grid, so voxelSize should be smaller than the 
+//       thinnest layer that matters.  
+//
+//       Drawing plugins may call this object from several threads at once.  Geometry puts its TGeoManager in 
+//       multi-threaded mode and gives each thread that navigates through it a TGeoNavigator of its own.  Configure with:
+//         maxThreads: Most threads that will navigate at once.  Defaults to std::thread::hardware_concurrency().
+//         voxelSize: Edge length of a voxel in mm.  Defaults to the smallest size that fits in maxVoxels.
+//         maxVoxels: Upper limit on the number of voxels.  0 turns the grid off.  Default is 4194304 (8MB).
 //Author: Andrew Olivier aolivier@ur.rochester.edu
 
 //yaml-cpp includes
@@ -12,9 +25,24 @@
 #include "TGeoMatrix.h"
 #include "TVector3.h"
 #include "TGeoVolume.h"
+#include "TGeoBBox.h"
+#include "TGeoTube.h"
+#include "TGeoMaterial.h"
+#include "TGeoNavigator.h"
+#include "TList.h"
 
 //c++ includes
 #include <memory> //For std::shared_ptr
+#include <atomic>
+#include <vector>
+#include <unordered_map>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <thread>
 
 #ifndef UTIL_GEOMETRY_CPP
 #define UTIL_GEOMETRY_CPP
@@ -25,21 +53,71 @@ namespace util
   {
     public:
       Geometry(const YAML::Node& config, TGeoManager* man): fFiducialNode(nullptr), fFiducialMatrix(nullptr), 
-                                                            fManager(man)
+                                                            fManager(man), fInstance(NextInstance())
       {
-        const auto fiducial = config["fiducial"].as<std::string>();
-        if(fiducial != nullptr) fFiducialName = fiducial;
+        if(config["fiducial"]) fFiducialName = config["fiducial"].as<std::string>();
         else fFiducialName = man->GetTopNode()->GetVolume()->GetName();
         SetFiducial();
+        SetThreads(config);
+        SetVoxels(config);
       }
 
       virtual ~Geometry() = default;
 
       bool IsFiducial(const TVector3& point) 
       {
-        const auto local = InLocal(point);  
-        double localArr[] = {local.X(), local.Y(), local.Z()};
-        return fFiducialNode->GetVolume()->Contains(localArr);        
+        const double x = point.X(), y = point.Y(), z = point.Z();
+        unsigned char inside;
+        IsFiducial(&x, &y, &z, 1, &inside);
+        return inside;
+      }
+
+      //Sets inside[i] to whether (x[i], y[i], z[i]) in the master frame is in the fiducial volume for n points.  
+      //Boxes and full tubes are tested in a loop the compiler can vectorize.  Other shapes go through TGeoShape::Contains().
+      void IsFiducial(const double* x, const double* y, const double* z, const size_t n, unsigned char* inside)
+      {
+        //inside could alias any member, so copy everything the loops need to locals
+        const double r[9] = {fFiducialRot[0], fFiducialRot[1], fFiducialRot[2], fFiducialRot[3], fFiducialRot[4], 
+                             fFiducialRot[5], fFiducialRot[6], fFiducialRot[7], fFiducialRot[8]};
+        const double t[3] = {fFiducialTrans[0], fFiducialTrans[1], fFiducialTrans[2]};
+        const double o[3] = {fFiducialOrigin[0], fFiducialOrigin[1], fFiducialOrigin[2]};
+        const double h[3] = {fFiducialHalf[0], fFiducialHalf[1], fFiducialHalf[2]};
+        const double rMin2 = fFiducialRMin2, rMax2 = fFiducialRMax2;
+
+        switch(fFiducialShape)
+        {
+          case FiducialShape::Box:
+            for(size_t i = 0; i < n; ++i)
+            {
+              const double mx = x[i] - t[0], my = y[i] - t[1], mz = z[i] - t[2];
+              const double lx = mx*r[0] + my*r[3] + mz*r[6] - o[0], ly = mx*r[1] + my*r[4] + mz*r[7] - o[1], 
+                           lz = mx*r[2] + my*r[5] + mz*r[8] - o[2];
+              inside[i] = (std::fabs(lx) <= h[0]) & (std::fabs(ly) <= h[1]) & (std::fabs(lz) <= h[2]);
+            }
+            break;
+          case FiducialShape::Tube:
+            for(size_t i = 0; i < n; ++i)
+            {
+              const double mx = x[i] - t[0], my = y[i] - t[1], mz = z[i] - t[2];
+              const double lx = mx*r[0] + my*r[3] + mz*r[6], ly = mx*r[1] + my*r[4] + mz*r[7], 
+                           lz = mx*r[2] + my*r[5] + mz*r[8];
+              const double r2 = lx*lx + ly*ly;
+              inside[i] = (std::fabs(lz) <= h[2]) & (r2 >= rMin2) & (r2 <= rMax2);
+            }
+            break;
+          default:
+          {
+            Navigator(); //Shapes with per-thread scratch space need this thread to be known to fManager
+            const auto shape = fFiducialNode->GetVolume()->GetShape();
+            for(size_t i = 0; i < n; ++i)
+            {
+              const double master[] = {x[i], y[i], z[i]};
+              double local[3];
+              fFiducialMatrix->MasterToLocal(master, local);
+              inside[i] = shape->Contains(local);
+            }
+          }
+        }
       }
 
       TVector3 InLocal(const TVector3& point) 
@@ -55,16 +133,64 @@ namespace util
       {
         double local[] = {point.X(), point.Y(), point.Z()};
         double master[3] = {};
-        fFiducialMatrix->LocalToMaster(master, local);
+        fFiducialMatrix->LocalToMaster(local, master);
 
         return TVector3(master[0], master[1], master[2]);
       }
 
       const TGeoNode& GetFiducial() { return *fFiducialNode; }
 
+      //Distance from a point inside the fiducial volume to its boundary along dir.  Both are in the master frame.
+      double DistToFiducialBoundary(const TVector3& point, const TVector3& dir)
+      {
+        Navigator(); //Shapes with per-thread scratch space need this thread to be known to fManager
+
+        const double master[] = {point.X(), point.Y(), point.Z()}, masterDir[] = {dir.X(), dir.Y(), dir.Z()};
+        double local[3], localDir[3];
+        fFiducialMatrix->MasterToLocal(master, local);
+        fFiducialMatrix->MasterToLocalVect(masterDir, localDir);
+        return fFiducialNode->GetVolume()->GetShape()->DistFromInside(local, localDir, 3);
+      }
+
       const TGeoMaterial& FindMaterial(const TVector3& pos)
       {
-        return *(fManager->FindNode(pos.X(), pos.Y(), pos.Z())->GetVolume()->GetMaterial());
+        const double x = pos.X(), y = pos.Y(), z = pos.Z();
+        const TGeoMaterial* material;
+        FindMaterials(&x, &y, &z, 1, &material);
+        return *material;
+      }
+
+      //Sets materials[i] to the material at (x[i], y[i], z[i]) in the master frame for n points.  Consecutive points in 
+      //the same voxel, like samples along a short segment, cost one comparison after the first.
+      void FindMaterials(const double* x, const double* y, const double* z, const size_t n, const TGeoMaterial** materials)
+      {
+        size_t lastVoxel = fNVoxels;
+        uint16_t lastMaterial = kBoundary;
+        for(size_t i = 0; i < n; ++i)
+        {
+          const auto voxel = VoxelIndex(x[i], y[i], z[i]);
+          if(voxel < fNVoxels)
+          {
+            if(voxel != lastVoxel)
+            {
+              lastVoxel = voxel;
+              lastMaterial = fVoxels[voxel].load(std::memory_order_relaxed);
+              if(lastMaterial == kUnclassified) 
+              {
+                //Two threads may race to classify the same voxel, but they will both store the same answer.
+                lastMaterial = ClassifyVoxel(voxel);
+                fVoxels[voxel].store(lastMaterial, std::memory_order_relaxed);
+              }
+            }
+            if(lastMaterial != kBoundary) 
+            {
+              materials[i] = fMaterials[lastMaterial];
+              continue;
+            }
+          }
+
+          materials[i] = Navigator()->FindNode(x[i], y[i], z[i])->GetVolume()->GetMaterial();
+        }
       }
 
     private:
@@ -73,8 +199,111 @@ namespace util
       const TGeoMatrix* fFiducialMatrix; //A matrix that translates objects from the top Node's coordinate system to fFiducialNode's 
                                          //coordinate system.
       std::string fFiducialName; //The name of the fiducial volume to search for
+
+      //Copy of the fiducial volume's shape and transformation for batched IsFiducial()
+      enum class FiducialShape { Box, Tube, Other };
+      FiducialShape fFiducialShape = FiducialShape::Other;
+      double fFiducialRot[9] = {}; //Row-major rotation matrix from fFiducialMatrix
+      double fFiducialTrans[3] = {}; //Translation from fFiducialMatrix
+      double fFiducialOrigin[3] = {}; //Center of a box
+      double fFiducialHalf[3] = {}; //Half-lengths of a box, or half-length in z of a tube
+      double fFiducialRMin2 = 0, fFiducialRMax2 = 0; //Squared radii of a tube
       TGeoManager* fManager; 
 
+      //Per-thread navigation
+      struct NavigationState
+      {
+        TGeoManager* fManager;
+        std::mutex fMutex; //Serializes adding and removing fManager's navigators
+      };
+
+      //Owns one thread's navigator.  It gives the navigator back to fManager when the thread exits or moves on to 
+      //another Geometry, unless that Geometry has already been destroyed along with its TGeoManager.
+      class ThreadNavigator
+      {
+        public:
+          ~ThreadNavigator() { Release(); }
+
+          TGeoNavigator* Get(const std::shared_ptr<NavigationState>& state, const size_t instance)
+          {
+            if(fInstance != instance)
+            {
+              Release();
+              std::lock_guard<std::mutex> lock(state->fMutex);
+              fNavigator = state->fManager->GetCurrentNavigator();
+              if(fNavigator == nullptr) 
+              {
+                fNavigator = state->fManager->AddNavigator();
+                fState = state;
+              }
+              fInstance = instance;
+            }
+            return fNavigator;
+          }
+
+        private:
+          std::weak_ptr<NavigationState> fState; //Only set if this object added fNavigator
+          TGeoNavigator* fNavigator = nullptr;
+          size_t fInstance = 0; //Geometry that fNavigator came from
+
+          void Release()
+          {
+            if(auto state = fState.lock())
+            {
+              std::lock_guard<std::mutex> lock(state->fMutex);
+              state->fManager->RemoveNavigator(fNavigator);
+            }
+            fState.reset();
+            fNavigator = nullptr;
+            fInstance = 0;
+          }
+      };
+
+      const size_t fInstance; //Unique among all Geometry objects ever made so that old navigators are never reused
+      std::shared_ptr<NavigationState> fNavigation;
+
+      static size_t NextInstance()
+      {
+        static std::atomic<size_t> nextInstance(1);
+        return nextInstance++;
+      }
+
+      //The calling thread's navigator.  Each thread remembers the last Geometry it navigated so that the common case 
+      //skips TGeoManager's lookup by thread ID.
+      TGeoNavigator* Navigator()
+      {
+        thread_local ThreadNavigator navigator;
+        return navigator.Get(fNavigation, fInstance);
+      }
+
+      void SetThreads(const YAML::Node& config)
+      {
+        size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+        if(config["maxThreads"]) maxThreads = config["maxThreads"].as<size_t>();
+
+        fNavigation.reset(new NavigationState{fManager});
+        if(!fManager->IsClosed())
+        {
+          std::cerr << "util::Geometry: TGeoManager " << fManager->GetName() << " is not closed, so it can't navigate from "
+                    << "more than one thread.  Only use it from one thread at a time.\n";
+          return;
+        }
+
+        //ROOT sizes its per-thread scratch space by maxThreads and numbers threads in the order they first navigate.  
+        //Navigating from more than maxThreads different threads works but makes ROOT complain and grow that scratch space.
+        if(!fManager->IsMultiThread()) fManager->SetMaxThreads(maxThreads);
+      }
+
+      //Material voxel grid data
+      enum: uint16_t { kUnclassified = std::numeric_limits<uint16_t>::max(), kBoundary = kUnclassified - 1 };
+      std::vector<const TGeoMaterial*> fMaterials; //Materials that voxels refer to by index
+      std::unordered_map<const TGeoMaterial*, uint16_t> fMaterialIndex; //Index in fMaterials of each material 
+      std::unique_ptr<std::atomic<uint16_t>[]> fVoxels; //Index in fMaterials, kUnclassified, or kBoundary for each voxel
+      size_t fNVoxels = 0; //Total number of voxels.  0 when the grid is turned off.
+      size_t fNBins[3] = {}; //Number of voxels along each axis
+      double fGridMin[3] = {}; //Lowest corner of the grid in the master frame
+      double fVoxelSize = 0; //Edge length of a voxel in mm
+
       bool find_node(const TGeoNode* parent, const TGeoMatrix& mat)
       {
         TGeoHMatrix local(mat);
@@ -104,6 +333,153 @@ namespace util
           fFiducialNode = top;
           fFiducialMatrix = gGeoIdentity;
         }
+
+        //Only exact TGeoBBoxes and TGeoTubes.  Derived classes like TGeoTubeSeg have more to check.
+        const auto shape = fFiducialNode->GetVolume()->GetShape();
+        const auto rot = fFiducialMatrix->GetRotationMatrix();
+        const auto trans = fFiducialMatrix->GetTranslation();
+        std::copy(rot, rot+9, fFiducialRot);
+        std::copy(trans, trans+3, fFiducialTrans);
+        if(fFiducialMatrix->IsScale() || fFiducialMatrix->IsReflection()) fFiducialShape = FiducialShape::Other;
+        else if(shape->IsA() == TGeoBBox::Class())
+        {
+          const auto box = static_cast<const TGeoBBox*>(shape);
+          std::copy(box->GetOrigin(), box->GetOrigin()+3, fFiducialOrigin);
+          fFiducialHalf[0] = box->GetDX();
+          fFiducialHalf[1] = box->GetDY();
+          fFiducialHalf[2] = box->GetDZ();
+          fFiducialShape = FiducialShape::Box;
+        }
+        else if(shape->IsA() == TGeoTube::Class())
+        {
+          const auto tube = static_cast<const TGeoTube*>(shape);
+          fFiducialHalf[2] = tube->GetDz();
+          fFiducialRMin2 = tube->GetRmin()*tube->GetRmin();
+          fFiducialRMax2 = tube->GetRmax()*tube->GetRmax();
+          fFiducialShape = FiducialShape::Tube;
+        }
+      }
+
+      void SetVoxels(const YAML::Node& config)
+      {
+        size_t maxVoxels = 1 << 22;
+        if(config["maxVoxels"]) maxVoxels = config["maxVoxels"].as<size_t>();
+        if(config["voxelSize"]) fVoxelSize = config["voxelSize"].as<double>();
+
+        //Every TGeoShape is a TGeoBBox.  Transform the fiducial volume's bounding box to the master frame.
+        const auto box = dynamic_cast<const TGeoBBox*>(fFiducialNode->GetVolume()->GetShape());
+        if(maxVoxels == 0 || box == nullptr) return;
+
+        const double* origin = box->GetOrigin();
+        const double half[] = {box->GetDX(), box->GetDY(), box->GetDZ()};
+        double gridMax[3];
+        for(size_t axis = 0; axis < 3; ++axis)
+        {
+          fGridMin[axis] = std::numeric_limits<double>::max();
+          gridMax[axis] = std::numeric_limits<double>::lowest();
+        }
+
+        for(int corner = 0; corner < 8; ++corner)
+        {
+          double local[3], master[3];
+          for(size_t axis = 0; axis < 3; ++axis) local[axis] = origin[axis] + ((corner >> axis) & 1 ? half[axis] : -half[axis]);
+          fFiducialMatrix->LocalToMaster(local, master);
+          for(size_t axis = 0; axis < 3; ++axis)
+          {
+            fGridMin[axis] = std::min(fGridMin[axis], master[axis]);
+            gridMax[axis] = std::max(gridMax[axis], master[axis]);
+          }
+        }
+
+        double extent[3], volume = 1.;
+        for(size_t axis = 0; axis < 3; ++axis) 
+        {
+          extent[axis] = gridMax[axis] - fGridMin[axis];
+          volume *= std::max(extent[axis], 1e-3);
+        }
+        const double requested = fVoxelSize;
+        if(fVoxelSize <= 0.) fVoxelSize = std::cbrt(volume/maxVoxels);
+
+        //Grow voxels until the grid fits.  Rounding up the number of bins can push it over maxVoxels.
+        for(;;)
+        {
+          fNVoxels = 1;
+          for(size_t axis = 0; axis < 3; ++axis) 
+          {
+            fNBins[axis] = std::max<size_t>(1, std::ceil(extent[axis]/fVoxelSize));
+            fNVoxels *= fNBins[axis];
+          }
+          if(fNVoxels <= maxVoxels) break;
+          fVoxelSize *= std::max(1.01, std::cbrt(double(fNVoxels)/maxVoxels));
+        }
+
+        if(requested > 0. && fVoxelSize > requested)
+        {
+          std::cerr << "util::Geometry: voxelSize " << requested << " would need more than maxVoxels = " << maxVoxels 
+                    << " voxels.  Using voxelSize " << fVoxelSize << " instead.\n";
+        }
+
+        //Voxels refer to materials by index so that a whole voxel fits in 2 bytes
+        for(auto obj: *fManager->GetListOfMaterials())
+        {
+          const auto mat = static_cast<const TGeoMaterial*>(obj);
+          if(fMaterials.size() >= kBoundary)
+          {
+            std::cerr << "util::Geometry: Too many materials for a material voxel grid.  FindMaterial() will use the "
+                      << "navigator for every lookup.\n";
+            fNVoxels = 0;
+            return;
+          }
+          fMaterialIndex[mat] = static_cast<uint16_t>(fMaterials.size());
+          fMaterials.push_back(mat);
+        }
+
+        fVoxels.reset(new std::atomic<uint16_t>[fNVoxels]);
+        for(size_t voxel = 0; voxel < fNVoxels; ++voxel) fVoxels[voxel].store(kUnclassified, std::memory_order_relaxed);
+      }
+
+      //Returns fNVoxels for points outside the grid
+      size_t VoxelIndex(const double x, const double y, const double z) const
+      {
+        const double pos[] = {x, y, z};
+        size_t index = 0;
+        for(int axis = 2; axis >= 0; --axis)
+        {
+          const double bin = std::floor((pos[axis] - fGridMin[axis])/fVoxelSize);
+          if(!(bin >= 0. && bin < fNBins[axis])) return fNVoxels; //Also rejects NaN
+          index = index*fNBins[axis] + size_t(bin);
+        }
+        return index;
+      }
+
+      uint16_t ClassifyVoxel(size_t voxel)
+      {
+        double low[3];
+        for(size_t axis = 0; axis < 3; ++axis)
+        {
+          low[axis] = fGridMin[axis] + (voxel % fNBins[axis])*fVoxelSize;
+          voxel /= fNBins[axis];
+        }
+
+        //Sample the center first, then the 8 corners
+        uint16_t material = kUnclassified;
+        for(int sample = -1; sample < 8; ++sample)
+        {
+          double pos[3];
+          for(size_t axis = 0; axis < 3; ++axis) 
+          {
+            pos[axis] = low[axis] + ((sample < 0) ? 0.5 : ((sample >> axis) & 1))*fVoxelSize;
+          }
+
+          const auto node = Navigator()->FindNode(pos[0], pos[1], pos[2]);
+          if(node == nullptr) return kBoundary;
+          const auto found = fMaterialIndex.find(node->GetVolume()->GetMaterial());
+          if(found == fMaterialIndex.end()) return kBoundary;
+          if(material == kUnclassified) material = found->second;
+          else if(material != found->second) return kBoundary;
+        }
+
+        return material;
       }
   };
 }
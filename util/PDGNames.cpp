@@ -0,0 +1,39 @@
+//File: PDGNames.cpp
+//Brief: Caches particle names from TDatabasePDG by PDG code.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//util includes
+#include "util/PDGNames.h"
+
+//ROOT includes
+#include "TDatabasePDG.h"
+#include "TParticlePDG.h"
+
+//c++ includes
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+
+namespace util
+{
+  const std::string& PDGName(const int pdg)
+  {
+    //References to elements of an unordered_map survive rehashing
+    static std::unordered_map<int, std::string> names;
+    static std::shared_timed_mutex mutex;
+
+    {
+      std::shared_lock<std::shared_timed_mutex> lock(mutex);
+      const auto found = names.find(pdg);
+      if(found != names.end()) return found->second;
+    }
+
+    //TDatabasePDG reads its table the first time it is used, so only ask it while holding the exclusive lock
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    const auto found = names.find(pdg);
+    if(found != names.end()) return found->second; //Another thread got here first
+
+    const auto particle = TDatabasePDG::Instance()->GetParticle(pdg);
+    return names.emplace(pdg, particle ? std::string(particle->GetName()) : std::to_string(pdg)).first->second;
+  }
+}
@@ -0,0 +1,20 @@
+//File: PDGNames.h
+//Brief: Caches particle names from TDatabasePDG by PDG code.  Names are looked up under a shared lock so that drawing 
+//       plugins and the GUI can ask for them from several threads at once.  TDatabasePDG is only asked about a PDG code 
+//       the first time it is seen.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//c++ includes
+#include <string>
+
+#ifndef UTIL_PDGNAMES_H
+#define UTIL_PDGNAMES_H
+
+namespace util
+{
+  //Name of the particle with PDG code pdg, or pdg as a string if TDatabasePDG doesn't know about it.  The reference 
+  //stays valid for the rest of the program.
+  const std::string& PDGName(const int pdg);
+}
+
+#endif //UTIL_PDGNAMES_H